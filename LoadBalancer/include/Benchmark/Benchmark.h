@@ -0,0 +1,59 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+/////////////////////////////////////////////////////////////////////
+//  Benchmark.h - helpers shared by the benchmarks and the simulator
+//                of scheduling algorithms
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the helpers the benchmark and simulator programs share: the names of the
+* scheduling algorithms as given on the command line of the balancer,
+* a monotonic clock in nanoseconds, and a function which fills a
+* server table with made-up real servers. These programs only use
+* the scheduling algorithms and the server table, no socket is opened.
+*
+* Required Files:
+* ===============
+* Benchmark.h, Benchmark.cpp, SchedAlgorithms.h and the files needed by
+* SchedAlgorithms.h
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <stdint.h>
+#include "../SchedulingAlgorithms/SchedAlgorithms.h"
+
+
+struct AlgorithmName
+{
+    const char *name;
+    SchedAlgorithm type;
+};
+
+// All the scheduling algorithms, in the order of SchedAlgorithm
+extern const AlgorithmName ALGORITHM_NAMES[];
+extern const int ALGORITHM_COUNT;
+
+// Return the type of an algorithm by its name, false if not found
+bool findAlgorithm(const std::string& name, SchedAlgorithm& type);
+
+// Monotonic time in nanoseconds
+uint64_t getNanoTime();
+
+// Add size servers to an empty table, at addresses 10.x.y.z. The fds
+// are from 1 to size, server i has max_load max_loads[i % count].
+void fillServerTable(ServerTable& table, int size,
+                     const int *max_loads, int count);
+
+
+#endif
@@ -21,12 +21,16 @@
 * Interface.h, ErrorHandle.h, ErrorHandler.cpp, SocketCreator.h,
 * SocketCreator.cpp, HTTPBasic.h, HTTPWriter.cpp, ResponseMessage.cpp,
 * RequestMessage.cpp, HTTPReader.h, HTTPReader.cpp, ResponseHandler.cpp,
-* GetCurrTime.h, GetCurrTime.cpp, Cache.h, ClientManager.h, ClientManager.cpp
+* GetCurrTime.h, GetCurrTime.cpp, ConnBuffer.h, ConnBuffer.cpp, Cache.h,
+* ClientManager.h, ClientManager.cpp
 *
 * Maintenance History:
 * ====================
 * ver 1.0 : 5 Aug 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - send requests with their real length, and read a response until
+*   it is complete
 */
 
 
@@ -39,6 +43,7 @@
 
 #include "../Common/GetCurrTime.h"
 #include "../Common/SocketCreator.h"
+#include "../Common/ConnBuffer.h"
 #include "../HTTP/HTTPReader/HTTPReader.h"
 #include "Cache.h"
 
@@ -0,0 +1,122 @@
+#ifndef CONN_BUFFER_H
+#define CONN_BUFFER_H
+/////////////////////////////////////////////////////////////////////
+//  ConnBuffer.h - input and output buffers of one connection
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the ConnBuffer class, which keeps the state of reading and
+* writing HTTP messages on one socket. A read() on a stream socket may
+* return part of a message, or several messages, and a write() may
+* send only part of the data. So the bytes read are accumulated in an
+* input buffer, and a message is taken out only when it is complete,
+* which is known from the empty line after the header and from the
+* Content-Length header.
+* The messages to send are appended to an output queue, and the queue
+* is flushed as far as the socket accepts; the rest is sent when the
+* socket becomes writable (EPOLLOUT).
+* The socket is read and written with MSG_DONTWAIT, so a call never
+* blocks, even if O_NONBLOCK of the socket is not set.
+* readFull() and writeFull() are used for blocking sockets, such as
+* the stream pipe between a real server and its children, which loop
+* until the whole buffer is transferred. On such a pipe, a message is
+* sent behind its length by writeMessage() and read by readMessage().
+*
+* Required Files:
+* ===============
+* Interface.h, ErrorHandler.h, ErrorHandler.cpp, HTTPBasic.h,
+* ConnBuffer.h, ConnBuffer.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* ver 1.1 : 16 Oct 2026
+* - frame messages by header and Content-Length instead of 4096 bytes
+*/
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <strings.h>
+#include <ctype.h>
+#include <vector>
+#include <algorithm>
+#include "ErrorHandler.h"
+#include "../HTTP/HTTPWriter/HTTPBasic.h"
+
+
+//***********************************************************************
+// ConnBuffer
+//
+// The state of one connection: the bytes read but not taken out as a
+// message, the bytes waiting to be sent, and whether the peer has
+// closed the connection.
+//***********************************************************************
+
+class ConnBuffer
+{
+public:
+    // state of reading, from the view of the peer
+    enum ReadState { READ_OPEN, READ_EOF, READ_ERROR };
+
+    ConnBuffer();
+
+    // Read all the bytes available now into the input buffer.
+    ReadState readFrom(int fd);
+    ReadState getReadState() const;
+
+    // Read a blocking socket until a message is complete.
+    bool waitMessage(int fd, HTTPMessage& msg);
+
+    // Append bytes read by the owner into the input buffer.
+    void append(const char *data, size_t n);
+
+    // Take the next complete message out of the input buffer.
+    bool getMessage(HTTPMessage& msg);
+
+    // Append a message to the output queue.
+    void queueMessage(const HTTPMessage& msg);
+    bool hasOutput() const;
+
+    // Send the output queue.
+    // return: -1 -- occur an error
+    //          0 -- all the output is sent
+    //          1 -- part of output is left, wait for EPOLLOUT
+    int flushTo(int fd);
+
+    // events of the socket registered in epoll fd, kept by the owner
+    uint32_t getEvents() const;
+    void setEvents(uint32_t events);
+
+    // transfer exactly n bytes on a blocking fd
+    static ssize_t readFull(int fd, void *buf, size_t n);
+    static ssize_t writeFull(int fd, const void *buf, size_t n);
+
+    // transfer a message behind its length on a blocking stream pipe
+    static int writeMessage(int fd, const HTTPMessage& msg);
+    static int readMessage(int fd, HTTPMessage& msg);
+private:
+    static const size_t READ_SIZE = 16384; // bytes asked by one read
+
+    void reserveInput(size_t n);
+    ssize_t receive(int fd, int flags);
+    static int getContentLength(const char *header, size_t len, size_t& length);
+
+    std::vector<char> input_;
+    size_t input_begin_;     // first byte not taken out
+    size_t input_end_;       // end of bytes read
+    std::vector<char> output_;
+    size_t output_begin_;    // first byte not sent
+    ReadState read_state_;
+    uint32_t events_;
+};
+
+
+#endif
@@ -24,6 +24,11 @@
 * ====================
 * ver 1.0 : 8 June 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - add addEventMask() to add an fd with given events, such as EPOLLOUT
+*   and EPOLLET
+* - add modifyEvent() to change the events of an fd, e.g. to wait for
+*   EPOLLOUT while output is pending
 */
 
 #include <sys/epoll.h>
@@ -59,6 +64,8 @@ int disableCloseOnExec(int fd);
 
 // Add and Remove an fd to and from an epollfd monitoring list
 void addEvent(int epollfd, int fd, OneShotType oneshot_type, BlockType block_type);
+void addEventMask(int epollfd, int fd, uint32_t events, BlockType block_type);
+void modifyEvent(int epollfd, int fd, uint32_t events);
 void deleteEvent(int epollfd, int fd);
 
 // Enable and disable EPOLLONESHOT of a file descriptor 
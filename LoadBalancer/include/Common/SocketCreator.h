@@ -52,6 +52,10 @@ public:
                    const char *service, 
                    int backlog, 
                    socklen_t *addrlen);
+    int inetReusePortListen(const char *host, 
+                            const char *service, 
+                            int backlog, 
+                            socklen_t *addrlen);
     int inetBind(const char *host, 
                  const char *service, 
                  int type, 
@@ -66,7 +70,8 @@ private:
                           const char *service, 
                           int type, 
                           socklen_t *addrlen,
-                          bool do_listen, int backlog);
+                          bool do_listen, int backlog,
+                          bool reuse_port = false);
 
     const static int IS_ADDR_STR_LEN = 4096;
 };
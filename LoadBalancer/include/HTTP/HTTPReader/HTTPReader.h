@@ -24,6 +24,9 @@
 * ====================
 * ver 1.0 : 10 Jul 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - handle Request-ID header and send it back in the response
+* - read the whole file in GET, so a body may be longer than 4096 bytes
 */
 
 
@@ -155,18 +158,24 @@ public:
     HTTPMessage deleteResponse();
     HTTPMessage serverCheckResponse(std::string& max_load);
     HTTPMessage errorResponse(std::string& error_code);
+
+    const std::string& getRequestID() const;
 private:
     void initHeaderHandlerTable();
     void getHeaderInfo(); // get information after ':' in a line of header
 
     // invoke corresponding method handlers 
     int handleHeaders(const std::string& method); 
+
+    // read a whole file under a read lock
+    static ssize_t readContent(int fd, std::string& content);
     
     // handle different headers, used in every method handler table
     static void handleHost(ResponseHandler*);
     static void handleAccept(ResponseHandler*);
     static void handleSourceIP(ResponseHandler*);
     static void handleSourcePort(ResponseHandler*);
+    static void handleRequestID(ResponseHandler*);
     static void handleContentType(ResponseHandler*);
     static void handleContentLength(ResponseHandler*);
 
@@ -197,6 +206,7 @@ private:
     std::string content_;
     std::string target_ip_;
     std::string target_port_;
+    std::string request_id_;
 };
 
 
@@ -15,6 +15,8 @@
 * Define concepts of status code and HTTP message. Status code is used
 * for clients to understand results of their requests. HTTP message is
 * defined as a struct, with a static const variable and a string.
+* The string keeps the length of the message, so only the bytes of
+* the message are sent, and a large body makes the string grow.
 *
 * Required Files:
 * ===============
@@ -24,6 +26,8 @@
 * ====================
 * ver 1.0 : 10 Jul 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - HTTPMessage holds a std::string instead of a fixed 4096-byte array
 */
 
 
@@ -106,13 +110,16 @@ namespace StatusCode
 // HTTPMessage
 //
 // The struct is used in HTTPWriter and HTTPReader, defined as the bridge
-// between clients and servers.
+// between clients and servers. A message on the wire is framed by its
+// header and Content-Length, instead of being padded to a fixed size.
 //***********************************************************************
 
 struct HTTPMessage
 {
-    static const int HTTP_MSG_SIZE = 4096;
-    char http_msg[HTTP_MSG_SIZE];
+    static const size_t HTTP_MSG_SIZE = 4096;           // usual size, reserved
+    static const size_t MAX_HEADER_SIZE = 65536;        // start line and header
+    static const size_t MAX_MSG_SIZE = 64 * 1024 * 1024;
+    std::string http_msg;
 };
 
 
@@ -42,12 +42,17 @@
  * ====================
  * ver 1.0 : 10 Jul 2014
  * - first release
+ * ver 1.1 : 16 Oct 2026
+ * - add insertHeader() to add a header to a constructed HTTP message
+ * - add removeHeader() to take a header out of a constructed HTTP message
+ * - constructHTTPMsg() builds a message of its real length, and sets
+ *   Content-Length to the length of body
 */
 
 
 #include "HTTPBasic.h"
 #include <string>
-#include <cstring> // used for sprintf
+#include <cstring>
 
 
 
@@ -89,7 +94,15 @@ public:
 
     HTTPWriter& clear();
     void showInfo(const HTTPMessage& http_msg);
+
+    // insert a header line behind start line of a constructed HTTP message
+    static int insertHeader(HTTPMessage& http_msg, const char *header);
+
+    // remove a header line of a constructed HTTP message, and get its content
+    static int removeHeader(HTTPMessage& http_msg, const char *name, std::string& content);
 protected:
+    void setContentLength();
+
     std::string start_line_;
     std::string header_;
     std::string body_;
@@ -0,0 +1,118 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+/////////////////////////////////////////////////////////////////////
+//  IoUring.h - a small wrapper of Linux io_uring interface
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the IoUring class, which sets up an io_uring instance by the
+* raw system calls io_uring_setup(), io_uring_enter() and
+* io_uring_register(), so that no library is needed.
+* A user gets a submission queue entry (SQE) by getSqe(), fills it by
+* one of the prep functions, and submits all the prepared entries in
+* one io_uring_enter() call by submit(). Completion queue entries (CQE)
+* are read by peekCqe().
+* io_uring needs Linux 5.19 or later for multishot accept. If the ring
+* cannot be created, init() returns -1 and the caller should fall back
+* to epoll.
+*
+* Required Files:
+* ===============
+* Interface.h, ErrorHandler.h, ErrorHandler.cpp, IoUring.h, IoUring.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* ver 1.1 : 16 Oct 2026
+* - add prepWrite() for buffers which are not registered
+*/
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include "../Common/ErrorHandler.h"
+
+
+//***********************************************************************
+// IoUring
+//
+// One submission queue and one completion queue, used by one thread.
+//***********************************************************************
+
+class IoUring
+{
+public:
+    IoUring();
+    ~IoUring();
+    IoUring(const IoUring& ) = delete;
+    IoUring& operator=(const IoUring& ) = delete;
+
+    int init(unsigned entries); // create the rings
+    void destroy();             // unmap the rings and close ring fd
+
+    // register count buffers of size bytes, starting from base
+    int registerBuffers(char *base, unsigned count, size_t size);
+
+    // Get a free SQE. If the submission queue is full, the prepared
+    // entries are submitted first.
+    struct io_uring_sqe* getSqe();
+
+    // Submit prepared entries and wait for at least wait_nr completions.
+    int submit(unsigned wait_nr);
+
+    // Copy the next CQE into cqe. Return false if there is none.
+    bool peekCqe(struct io_uring_cqe& cqe);
+
+    // fill an SQE for different operations
+    static void prepAcceptMultishot(struct io_uring_sqe *sqe, int fd, uint64_t user_data);
+    static void prepReadFixed(struct io_uring_sqe *sqe, int fd, char *buf,
+                              unsigned len, int buf_index, uint64_t user_data);
+    static void prepWriteFixed(struct io_uring_sqe *sqe, int fd, char *buf,
+                               unsigned len, int buf_index, uint64_t user_data);
+    static void prepRead(struct io_uring_sqe *sqe, int fd, void *buf,
+                         unsigned len, uint64_t user_data);
+    static void prepWrite(struct io_uring_sqe *sqe, int fd, const void *buf,
+                          unsigned len, uint64_t user_data);
+    static void prepClose(struct io_uring_sqe *sqe, int fd, uint64_t user_data);
+private:
+    static void prepRw(struct io_uring_sqe *sqe, int op, int fd, const void *addr,
+                       unsigned len, uint64_t offset, uint64_t user_data);
+
+    int ring_fd_;
+
+    // submission queue
+    unsigned *sq_head_;
+    unsigned *sq_tail_;
+    unsigned *sq_mask_;
+    unsigned *sq_array_;
+    struct io_uring_sqe *sqes_;
+    unsigned sq_entries_;
+    unsigned sqe_tail_;     // local tail, published in submit()
+    unsigned sqe_submitted_;
+
+    // completion queue
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned *cq_mask_;
+    struct io_uring_cqe *cqes_;
+
+    // mapped regions
+    void *sq_ring_;
+    void *cq_ring_;
+    size_t sq_ring_size_;
+    size_t cq_ring_size_;
+    size_t sqes_size_;
+};
+
+
+#endif
@@ -15,109 +15,321 @@
 * This file defines the LoadBalancer class to balance loads among
 * servers. The load balancer receives requests from clients and send
 * them to appropriate servers by using different scheduling algorithms.
+* The load balancer can run several workers, one per core. Every worker
+* is a process with its own listen socket (SO_REUSEPORT), epoll fd and
+* connections to real servers, while loads of real servers are shared
+* among workers.
+* In passthrough mode, the load balancer does not parse messages. It
+* connects every client to a real server and moves bytes between them
+* with splice().
+* The event loop of a worker is driven by epoll, or by io_uring if it
+* is selected and supported by the kernel.
+* Every real server has one control connection, which is used for
+* SERVERCHECK and health check, and a pool of connections for requests,
+* so that requests sent to one real server are not queued behind each
+* other in one socket.
+* A client connection is kept open across requests if the requests
+* have "Connection: keep-alive" header (epoll engine only).
+* Sockets of clients and real servers are read into a ConnBuffer of
+* each connection, so a message split by the network, or several
+* messages in one read, are handled. Output which cannot be sent at
+* once is kept in the ConnBuffer and sent when EPOLLOUT is reported.
 *
 * Required Files:
 * ===============
 * Interface.h, ErrorHandle.h, ErrorHandler.cpp, SocketCreator.h, 
 * SocketCreator.cpp, HTTPBasic.h, HTTPWriter.cpp, ResponseMessage.cpp,
 * RequestMessage.cpp, HTTPReader.h, HTTPReader.cpp, ResponseHandler.cpp,
-* FdHandler.h, SchedAlgorithm.h, SchedRR.cpp, SchedWRR.cpp, SchedLC.cpp,
-* SchedWLC.cpp, SchedDH.cpp, SchedSH.cpp, AlgorithmSelector.cpp, 
-* LoadBalancer.h, LoadBalancer.cpp
+* FdHandler.h, ConnBuffer.h, ConnBuffer.cpp, ServerTable.h, ServerTable.cpp,
+* ServerHeap.h, ServerHeap.cpp, HashRing.h, HashRing.cpp,
+* SchedAlgorithm.h, SchedRR.cpp, SchedWRR.cpp, SchedHeap.cpp, SchedLC.cpp,
+* SchedWLC.cpp, SchedHashing.cpp, SchedDH.cpp, SchedSH.cpp, 
+* SchedP2C.cpp, SchedMaglev.cpp, SchedPeakEWMA.cpp, SchedSED.cpp,
+* SchedNQ.cpp, DestinationTable.h, DestinationTable.cpp, SchedLBLC.cpp,
+* AlgorithmVisitor.h, AlgorithmSelector.cpp,
+* SharedLoadTable.h, SharedLoadTable.cpp, RequestTable.h, RequestTable.cpp,
+* Tunnel.h, Tunnel.cpp, IoUring.h, IoUring.cpp, TimerList.h, 
+* TimerList.cpp, TimerWheel.h, TimerWheel.cpp, LoadBalancer.h, 
+* LoadBalancer.cpp
 *
 * Maintenance History:
 * ====================
 * ver 1.0 : 6 Aug 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - multi-core mode, one worker process per core
+* - find the request of a response by Request-ID instead of client's
+*   IP address and port number
+* - passthrough mode, splice() bytes between client and real server
+* - io_uring engine, selected by -u, falls back to epoll
+* - health check does not block the event loop. Probes are sent with
+*   request IDs and every real server has a timer fd for time out
+* - a pool of persistent connections to every real server
+* - keep-alive client connections. Pipelined requests are answered in
+*   order, and idle connections are closed after a time out
+* - per-connection buffers for partial reads and writes, output is
+*   flushed on EPOLLOUT. io_uring engine resubmits short transfers
+* - messages are framed by Content-Length instead of a fixed size.
+*   io_uring engine reads into registered buffers and frames the
+*   bytes by a ConnBuffer of each connection
+* - requests not answered in REQUEST_TIME_OUT seconds get 504, timers
+*   are kept in a hierarchical timer wheel
+* - real servers are kept in a ServerTable shared with the scheduling
+*   algorithm, loads are updated in place instead of copying the pool
+*   before every selection
+* - P2C, power of two choices scheduling algorithm
+* - the address of the client is passed to the scheduling algorithm,
+*   so DH and SH map clients by a consistent hash ring
+* - MH, Maglev hashing scheduling algorithm
+* - -e bounds loads of DH and SH to (1 + epsilon) times the average
+* - response time of every request and probe is measured and kept as
+*   a peak EWMA of the real server. PEWMA scheduling algorithm uses it
+* - SED and NQ scheduling algorithms
+* - LBLC scheduling algorithm, the URL of a request is passed to the
+*   scheduling algorithm. -x sets the expire time of its entries
+* - a slot of the selected real server is reserved in the shared load
+*   table before a request is sent, so workers cannot go over its max
+*   load together. Response times are shared by the workers, and a
+*   server one worker finds down is removed by the others
+* - SIGHUP reloads the configuration file given by -f: scheduling
+*   algorithm, max loads of real servers, -e and -x. The master passes
+*   SIGHUP to the workers, and keeps the configuration for a worker
+*   forked again
+* - response times of real servers decay while they get no requests
 */
 
 
 #include <sys/epoll.h>
 #include <sys/timerfd.h> 
 #include <sys/signalfd.h>
-#include <sys/select.h> 
+#include <sys/wait.h>
 #include <signal.h>
 #include <unordered_map>
 #include <map>
+#include <deque>
+#include <vector>
 #include <string>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
 
 #include "../Common/SocketCreator.h"
 #include "../Common/FdHandler.h"
+#include "../Common/ConnBuffer.h"
 #include "../HTTP/HTTPReader/HTTPReader.h"
 #include "../SchedulingAlgorithms/SchedAlgorithms.h"
 #include "CreatePidFile.h"
+#include "SharedLoadTable.h"
+#include "RequestTable.h"
+#include "Tunnel.h"
+#include "IoUring.h"
+#include "TimerList.h"
+#include "TimerWheel.h"
 
 
 //-------------------------------------------------------------------
-// One line of a header is like this:
-// Content-Type: text/plain
-// (target)       (content)
-// This function is used to get content after symbol ':' according
-// to target string.
+// Get the URL of a request, which is between the method and the HTTP
+// version in the request line.
 //-------------------------------------------------------------------
-static void getHeaderInfo(const HTTPMessage& msg, 
-                          std::string& content, 
-                          const std::string& target)
+static void getRequestURL(const HTTPMessage& msg, std::string& url)
 {
-    std::string received_msg = msg.http_msg;
-    decltype(target.size()) found = received_msg.find(target);
-    decltype(target.size()) index;
+    const std::string& received_msg = msg.http_msg;
+    size_t line_end = received_msg.find("\r\n");
+    size_t begin = received_msg.find(' ');
+    if (begin == std::string::npos || begin >= line_end)
+        return;
 
-    if (found != std::string::npos)
-    {
-        index = found + target.size();
-        for (decltype(index) i = index; i < received_msg.size() - 1; i++)
-        {
-            if (received_msg.at(i) == '\r' && received_msg.at(i + 1) == '\n')
-            {
-                content = received_msg.substr(index, i - index);
-                break;
-            }
-        }
-    }
+    begin++;
+    size_t end = received_msg.find(' ', begin);
+    if (end == std::string::npos || end > line_end)
+        end = line_end;
+    url = received_msg.substr(begin, end - begin);
 }
 
 //-------------------------------------------------------------------
-// Get target IP address by finding the content after "Target-IP: ".
+// Get request ID by finding the content after "Request-ID: ".
 // This function is used to find target client's file descriptor in
-// clients' requests map.
+// request table. It parses the message in place and returns 
+// RequestTable::INVALID_ID if there is no such header.
 //-------------------------------------------------------------------
-static void getTargetIP(const HTTPMessage& msg, std::string& target_ip)
+static RequestTable::RequestID getRequestID(const HTTPMessage& msg)
 {
-    getHeaderInfo(msg, target_ip, "Target-IP: ");
+    static const char target[] = "Request-ID: ";
+
+    // Only the header is searched, not the body.
+    size_t msg_len = msg.http_msg.find("\r\n\r\n");
+    if (msg_len == std::string::npos)
+        msg_len = msg.http_msg.size();
+
+    const char *found = static_cast<const char*>(
+        memmem(msg.http_msg.data(), msg_len, target, sizeof(target) - 1));
+    if (found == NULL)
+        return RequestTable::INVALID_ID;
+
+    return strtoul(found + sizeof(target) - 1, NULL, 10);
 }
 
 //-------------------------------------------------------------------
-// Get target port number by finding the content after "Target-Port: ".
-// This function is used to find target client's file descriptor in
-// clients' requests map.
+// Get the time of CLOCK_MONOTONIC in microseconds, which is used to
+// measure response time of real servers.
+//-------------------------------------------------------------------
+static uint64_t getMonotonicTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
 //-------------------------------------------------------------------
-static void getTargetPort(const HTTPMessage& msg, std::string& target_port)
+// Check whether a request asks to keep the connection alive. The
+// "Connection" header only applies to the connection between client
+// and load balancer, so it is removed before the request is sent to a
+// real server.
+//-------------------------------------------------------------------
+static bool getKeepAlive(HTTPMessage& msg)
 {
-    getHeaderInfo(msg, target_port, "Target-Port: ");
+    std::string content;
+    if (HTTPWriter::removeHeader(msg, "Connection", content) == -1)
+        return false;
+
+    return strcasecmp(content.c_str(), "keep-alive") == 0;
 }
 
 //-------------------------------------------------------------------
-// Get HTTP message body by finding the content after "\r\n".
+// Get HTTP message body, which is the content after "\r\n\r\n".
 //-------------------------------------------------------------------
 static void getBody(const HTTPMessage& msg, std::string& body)
 {
-    getHeaderInfo(msg, body, "\r\n\r\n");
+    size_t found = msg.http_msg.find("\r\n\r\n");
+    if (found != std::string::npos)
+        body = msg.http_msg.substr(found + 4);
+}
+
+//-------------------------------------------------------------------
+// Get the scheduling algorithm by its name, e.g. "WLC".
+// return: false if the name is not known
+//-------------------------------------------------------------------
+static bool getSchedAlgorithm(const std::string& name, SchedAlgorithm& sched_type)
+{
+    static const std::unordered_map<std::string, SchedAlgorithm> algorithm_map = {
+        { "RR", Round_Robin },
+        { "WRR", Weighted_Round_Robin },
+        { "LC", Least_Connection },
+        { "WLC", Weighted_Least_Connection },
+        { "DH", Destination_Hashing },
+        { "SH", Source_Hashing },
+        { "P2C", Power_Of_Two_Choices },
+        { "MH", Maglev_Hashing },
+        { "PEWMA", Peak_EWMA },
+        { "SED", Shortest_Expected_Delay },
+        { "NQ", Never_Queue },
+        { "LBLC", Locality_Based_Least_Connection }
+    };
+
+    auto found = algorithm_map.find(name);
+    if (found == algorithm_map.end())
+        return false;
+
+    sched_type = found->second;
+    return true;
 }
 
 
 //***********************************************************************
-// RequestInfo
+// BalancerConfig
+//
+// This struct stores options of a load balancer given by user.
+// worker_count is the number of worker processes. When it is 1, the
+// load balancer runs one event loop in a single process.
+// passthrough selects TCP passthrough mode instead of HTTP mode.
+// io_uring selects io_uring engine instead of epoll.
+// pool_size is the number of connections for requests to every real
+// server.
+// hash_load_bound is epsilon of consistent hashing with bounded loads
+// in DH and SH. A negative value means loads are not bounded.
+// expire_time is the time in seconds after which LBLC forgets the
+// server of a URL not requested, 0 means the default.
+// config_file is the file read again when SIGHUP is caught, nullptr if
+// it is not given.
+//***********************************************************************
+
+struct BalancerConfig
+{
+    int worker_count;
+    bool passthrough;
+    bool io_uring;
+    int pool_size;
+    double hash_load_bound;
+    int expire_time;
+    const char *config_file;
+};
+
+
+//***********************************************************************
+// HealthProbe
 //
-// This struct stores information of a request, including the client's
-// IP address and file descriptor.
+// This struct stores the health check state of a real server. A probe
+// is an OPTIONS message sent on the control connection of the server,
+// with its own request ID, so that the event loop never waits for it.
+// timer_fd expires when the response does not come back in time.
+// request_id is INVALID_ID when no probe is waiting.
 //***********************************************************************
 
-struct RequestInfo
+struct HealthProbe
 {
-    std::string client_addr;
-    int client_fd;
+    int timer_fd;
+    RequestTable::RequestID request_id;
+};
+
+
+//***********************************************************************
+// PoolConnection
+//
+// One connection in the pool of a real server. in_flight is the number
+// of requests sent on the connection and not answered yet. fd is -1
+// after the connection drops, and it is connected again when it is
+// selected.
+//***********************************************************************
+
+struct PoolConnection
+{
+    int fd;
+    int in_flight;
+};
+
+
+//***********************************************************************
+// PendingResponse
+//
+// The response of a request from a client connection. Responses are
+// sent in order of requests, so a response which comes back early is
+// kept here until the responses before it have been sent.
+//***********************************************************************
+
+struct PendingResponse
+{
+    RequestTable::RequestID request_id; // INVALID_ID before it is sent
+    bool ready;       // response has come back
+    bool keep_alive;  // keep connection open after the response
+    HTTPMessage response;
+};
+
+
+//***********************************************************************
+// ClientConnection
+//
+// A client connection kept by the load balancer. closing means that
+// no more request is read from the client, and the connection will be
+// closed after the pending responses have been sent.
+//***********************************************************************
+
+struct ClientConnection
+{
+    char client_addr[NI_MAXHOST];
+    char client_port[NI_MAXSERV];
+    std::deque<PendingResponse> responses;
+    bool closing;
+    ConnBuffer buffer; // requests read and responses not sent yet
 };
 
 
@@ -140,47 +352,134 @@ enum Status { SUCCESS = 0,     // function succeed
 // balance loads between real servers. 
 // The principle of a load balancer is:
 // A load balancer receives a request from a client, stores the client's
-// information as a RequestInfo object and puts it in request map. Then
-// the load balancer sends this request to an available server by a 
-// scheduling algorithm. After the real server finishes its work and sends
-// response back, load balancer checks the message, get target IP and port
-// number, find corresponding socket file descriptor in request map and
-// sends it back.
+// information as a RequestInfo object in request table and adds the
+// request ID to the request. Then the load balancer sends this request
+// to an available server by a scheduling algorithm. After the real server
+// finishes its work and sends response back with the same request ID, 
+// load balancer finds corresponding socket file descriptor in request
+// table and sends it back.
+// In multi-core mode, the object created in main() becomes the master.
+// It forks the workers, restarts a worker which exits unexpectedly and
+// stops all of them when it catches SIGINT or SIGTERM. Every worker
+// works on its own copy of the object.
 //***********************************************************************
 
 class LoadBalancer
 {
 public:
-    using ServerPool = std::unordered_map<int, RealServer>;
-    using RequestMap = std::multimap<std::string, RequestInfo>;
-
     // Use singleton pattern to create only one load balancer
-    static LoadBalancer* create(SchedAlgorithm sched_type);
+    static LoadBalancer* create(SchedAlgorithm sched_type, const BalancerConfig& config);
     ~LoadBalancer();
     LoadBalancer(const LoadBalancer& ) = delete;
     LoadBalancer& operator=(const LoadBalancer& ) = delete;
 
     void start();  // entry point of work of load balancer
+    void startWorker(); // event loop of a worker
     Status connectRealServers(); // try to connect to different real servers
-    Status handleRequestFromClient(); // get requests from clients and send them to servers
+    Status acceptClient(); // accept a client connection
+    Status handleRequestFromClient(int trigger_fd); // get requests from clients and send them to servers
     Status handleResultFromServer(int trigger_fd); // get results from servers and send them to clients
+    Status acceptTunnel(); // connect a client to a real server in passthrough mode
+    Status handleTunnel(int trigger_fd); // move bytes of a tunnel in passthrough mode
     Status healthCheck(); // check the servers' health
     Status handleSignal(); // handle different signals
-
-    void setServerPool(const ServerPool& server_pool);
+    Status reloadConfig(); // read the configuration file again
 private:
+    Status readConfig(SchedAlgorithm& sched_type, double& epsilon, int& expire_time,
+                      std::vector<std::pair<std::string, int>>& weights);
+    Status reloadMasterConfig(); // keep the configuration for new workers
+
     // Constructor is private.
-    LoadBalancer(SchedAlgorithm sched_type);
+    LoadBalancer(SchedAlgorithm sched_type, const BalancerConfig& config);
 
     // initialize data members 
     Status initEpollfd();
     Status initTimerfd(struct itimerspec& ts);
     Status initSignalfd();
     Status initListenfd();
+    Status initIdleTimer();
+    Status initRequestTimer();
+
+    void runEpollLoop(struct itimerspec& ts);
+    Status prepareRequest(int cfd, const char *host, const char *service,
+                          HTTPMessage& recv_msg, int& conn_fd,
+                          RequestTable::RequestID& request_id);
+    int matchResponse(const HTTPMessage& recv_msg);
+    int reserveServer();
+    void cancelReservation(int server_fd);
+    void addLoad(const RequestInfo& request);
+    void removeLoad(const RequestInfo& request);
+    void recordLatency(const RequestInfo& request);
+    void finishRequest(RequestTable::RequestID request_id);
+    void failRequest(RequestTable::RequestID request_id, const std::string& error_code);
+    void handleRequestTimeout(const std::vector<uint64_t>& expired);
+    Status handleRequest(int cfd, HTTPMessage& recv_msg);
+    void handleServerClosed(int fd);
+    Status sendToServer(int fd, const HTTPMessage& msg);
+    Status flushServer(int fd);
+    void watchOutput(int fd, ConnBuffer& buffer, bool reading);
+
+    // client connections
+    void completeResponse(int client_fd, RequestTable::RequestID request_id,
+                          const HTTPMessage& response);
+    void flushClient(int client_fd);
+    void closeClient(int client_fd);
+    void handleIdleTimeout();
+
+    // connection pools of real servers
+    int selectConnection(int server_fd);
+    Status openConnection(int server_fd, PoolConnection& conn);
+    void dropConnection(int conn_fd);
+    PoolConnection* findConnection(int conn_fd);
+    void closeServerfd(int fd);
+
+    // health check probes
+    Status addProbe(int server_fd);
+    void removeProbe(int server_fd);
+    Status prepareProbe(int server_fd, HTTPMessage& check_msg);
+    void handleProbeResult(int server_fd, RequestTable::RequestID request_id,
+                           const HTTPMessage& recv_msg);
+    Status handleProbeTimeout(int timer_fd);
+
+    // operations of io_uring engine
+    enum UringOp { URING_ACCEPT, URING_CLIENT_READ, URING_SERVER_WRITE, 
+                   URING_SERVER_READ, URING_CLIENT_WRITE, URING_CLOSE,
+                   URING_HEALTH_WRITE, URING_TIMER, URING_PROBE_TIMER,
+                   URING_SIGNAL, URING_REQUEST_TIMER };
+
+    Status initUring();
+    void runUringLoop(struct itimerspec& ts);
+    void handleUringCompletion(const struct io_uring_cqe& cqe, struct itimerspec& ts);
+    Status handleUringRequest(int cfd, int index, HTTPMessage& recv_msg);
+    void handleUringResponses(int server_fd);
+    Status uringHealthCheck();
+    Status postAccept();
+    Status postRead(UringOp op, int fd, int index);
+    Status postWrite(UringOp op, int fd, int index, bool close_after);
+    int acquireBuffer(bool reserved);
+    void releaseBuffer(int index);
+    void loadBuffer(int index, HTTPMessage& msg);
+    char* uringBuffer(int index);
+    static uint64_t packUserData(UringOp op, int index, int fd);
+
+    // operations of the master in multi-core mode
+    Status initMasterSignalfd();
+    Status forkWorker(int index);
+    void superviseWorkers();
+    void stopWorkers();
+
+    void syncServerLoad();
+    void syncServer(int index);
+    const RealServer& getServer(int server_fd) const;
+    void removeServer(int server_fd);
+    void closeTunnel(Tunnel *tunnel);
 
     void listRealServers();
     void listRequests();
     Status getSourceInfo(struct sockaddr* addr, socklen_t len, char *host, char *service);
+    void replyError(int client_fd, const std::string& error_code, 
+                    const char *host, const char *service,
+                    RequestTable::RequestID request_id = RequestTable::INVALID_ID);
     void clearAll();
 
     static LoadBalancer *instance; // static instance used in Singleton Pattern
@@ -189,19 +488,80 @@ private:
     int timer_fd_;
     int listen_fd_;
     int signal_fd_;
-    fd_set server_fds_;
     bool balancer_run_;
-    std::string target_ip_;
-    std::string target_port_;
     AlgorithmSelector *algorithm_selector_;
+    BalancerConfig config_;
+
+    // Index of this worker, 0 in single process mode.
+    int worker_index_;
+
+    // Pids of the workers, only used by the master.
+    std::vector<pid_t> worker_pids_;
+
+    // Current loads of the real servers, shared by all the workers.
+    // change_cursors_ is the place of this worker in the logs of the
+    // others, and changed_servers_ is reused to read them.
+    SharedLoadTable load_table_;
+    std::vector<uint64_t> change_cursors_;
+    std::vector<int> changed_servers_;
+
+    // Real servers, read by the scheduling algorithm. A server is found
+    // by the fd of its control connection, and its index is the same
+    // as in load_table_.
+    ServerTable server_table_;
+    uint64_t latency_decay_time_; // time response times were last decayed
+
+    // Requests waiting for responses from real servers.
+    // Key is request ID. Every request sent to a real server has a 
+    // timer in request_timers_, whose key is the slot index of the 
+    // request and whose data is the request ID.
+    RequestTable request_table_;
+    TimerWheel request_timers_;
+
+    // Connection pools. Key of conn_pools_ is servers' file descriptors,
+    // and conn_servers_ maps a pooled connection to the server's fd.
+    std::unordered_map<int, std::vector<PoolConnection>> conn_pools_;
+    std::unordered_map<int, int> conn_servers_;
+
+    // Buffers of control connections and pooled connections of the epoll
+    // engine, key is the connections' file descriptors.
+    std::unordered_map<int, ConnBuffer> server_buffers_;
+
+    // Client connections kept open, key is clients' file descriptors.
+    // Idle connections, which have no request being handled, are closed
+    // when their timers in idle_timers_ expire.
+    std::unordered_map<int, ClientConnection> client_conns_;
+    TimerList idle_timers_;
+
+    // Tunnels in passthrough mode. Key is both the client's and the 
+    // real server's file descriptors of a tunnel.
+    std::unordered_map<int, Tunnel*> tunnel_map_;
 
-    // Hash table to store information of servers.
-    // Key is servers' file descriptors.
-    ServerPool server_pool_;
+    // Health check probes. Key of probes_ is servers' file descriptors,
+    // and probe_timers_ maps a probe's timer fd to the server's fd.
+    std::unordered_map<int, HealthProbe> probes_;
+    std::unordered_map<int, int> probe_timers_;
 
-    // Red Black Tree to store information of requests.
-    // Key is clients' port number.
-    RequestMap request_map_;
+    // io_uring engine. Registered buffers of HTTP_MSG_SIZE bytes are
+    // read into, and the bytes are framed by the ConnBuffer of the 
+    // connection: server_buffers_ for real servers, uring_requests_ for
+    // clients whose request is being read. A message to write is kept
+    // in uring_payloads_, and copied into the registered buffer if it
+    // fits. Free buffers are kept in free_buffers_. When the engine is
+    // running, a connection to a real server is closed after its last
+    // read completes, so that its fd is not reused while the read is
+    // still in the ring.
+    IoUring ring_;
+    bool uring_running_;
+    std::vector<char> uring_buffers_;
+    std::vector<std::string> uring_payloads_;
+    std::vector<unsigned> uring_done_; // bytes of a payload written
+    std::vector<int> free_buffers_;
+    std::unordered_map<int, ConnBuffer> uring_requests_;
+    uint64_t timer_expirations_;
+    uint64_t probe_expirations_; // shared by reads of all probe timers
+    uint64_t request_expirations_;
+    struct signalfd_siginfo signal_info_;
 
     static const char *PROGRAM_NAME;    // prpgram name used in createPidFile()
     static const char *PID_FILE;        // pid file needs to be locked
@@ -211,9 +571,17 @@ private:
     static const int MAX_EVENTS = 10;   // max number of events an epollfd can monitor
     static const int BACKLOG = 50;      // max number of fds a socket can listen one time
     static const int HEALTH_CHECK_INTERVAL = 30; // interval between two health check
-    static const int HEALTH_CHECK_TIME_OUT = 2;  // time out in one health check
+    static const int HEALTH_CHECK_TIME_OUT = 2;  // time out of one probe
+    static const int CLIENT_IDLE_TIME_OUT = 10;  // time out of an idle client connection
+    static const int REQUEST_TIME_OUT = 10;      // time out of a request sent to a real server
+    static const int REQUEST_TIMER_TICK = 100;   // tick of request timers in milliseconds
     static const int MAX_REAL_SERVER = 3; // max number of real servers a load balancer
                                           // can communicate with
+    static const int MAX_WORKERS = 64;    // max number of workers in multi-core mode
+    static const int MAX_POOL_SIZE = 64;  // max number of connections to a real server
+    static const int RESERVE_ATTEMPTS = 3; // servers selected for a request before 503
+    static const int URING_ENTRIES = 256; // number of SQEs of io_uring
+    static const int URING_BUFFERS = 256; // number of registered buffers
 };
 
 
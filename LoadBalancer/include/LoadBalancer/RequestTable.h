@@ -0,0 +1,119 @@
+#ifndef REQUEST_TABLE_H
+#define REQUEST_TABLE_H
+/////////////////////////////////////////////////////////////////////
+//  RequestTable.h - table of requests being handled by real servers
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define a table to store requests which have been sent to real servers
+* and are waiting for responses. Every request gets a request ID when
+* it is put into the table. The load balancer adds the ID to the request
+* as a "Request-ID" header, and the real server sends it back in the
+* response, so the load balancer finds the request by one array access.
+*
+* A request ID is made of two parts:
+* (1) low 16 bits: index of the slot storing the request
+* (2) high 16 bits: generation of the slot, which is increased every
+*     time the slot is reused. A response carrying an old generation
+*     (e.g. the request has been removed) is not matched to a new request.
+*
+* Required Files:
+* ===============
+* RequestTable.h, RequestTable.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* ver 1.1 : 16 Oct 2026
+* - record the connection a request is sent on
+* - getIndex() is public
+* - record the time a request is sent
+*/
+
+#include <netinet/in.h>
+#include <netdb.h>
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+
+//***********************************************************************
+// RequestInfo
+//
+// This struct stores information of a request, including the client's
+// IP address, port number and file descriptor, the real server handling
+// it, the connection it is sent on and when it is sent, in microseconds
+// of CLOCK_MONOTONIC. There is no dynamic memory in it,
+// so storing a request needs no allocation.
+//***********************************************************************
+
+struct RequestInfo
+{
+    char client_addr[INET6_ADDRSTRLEN];
+    char client_port[NI_MAXSERV];
+    int client_fd;
+    int server_fd; // key of the real server in server pool
+    int conn_fd;   // connection to the real server
+    uint64_t send_time;
+};
+
+
+//***********************************************************************
+// RequestTable
+//
+// A slot array with a free list. Slots are allocated when they are
+// first needed, up to MAX_REQUESTS, and reused afterwards.
+//***********************************************************************
+
+class RequestTable
+{
+public:
+    using RequestID = uint32_t;
+    using Visitor = std::function<void(RequestID, const RequestInfo&)>;
+
+    RequestTable();
+    ~RequestTable(){}
+
+    // Store a request and return its ID.
+    // Return INVALID_ID if the table is full.
+    RequestID insert(const RequestInfo& request);
+
+    // Return the request of this ID, or nullptr if there is no such request.
+    RequestInfo* find(RequestID id);
+
+    bool erase(RequestID id);
+    void forEach(const Visitor& visitor) const;
+    size_t size() const;
+
+    // Index of the slot of a request, less than MAX_REQUESTS, which can
+    // be used as a key of per-request data kept out of the table.
+    static uint32_t getIndex(RequestID id) { return id & 0xffff; }
+
+    static const RequestID INVALID_ID = 0;
+    static const uint32_t MAX_REQUESTS = 1 << 16;
+private:
+    struct Slot
+    {
+        RequestInfo request;
+        uint16_t generation;
+        bool in_use;
+        uint32_t next_free; // next free slot, valid when in_use is false
+    };
+
+    static uint16_t getGeneration(RequestID id) { return id >> 16; }
+
+    std::vector<Slot> slots_;
+    uint32_t free_head_; // first free slot, slots_.size() if there is none
+    size_t size_;
+};
+
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef SHARED_LOAD_TABLE_H
+#define SHARED_LOAD_TABLE_H
+/////////////////////////////////////////////////////////////////////
+//  SharedLoadTable.h - current loads of real servers shared by all
+//                      the workers of a load balancer
+//  ver 1.0                                                        
+//  Language:      standard C++ 11                                
+//  Platform:      Ubuntu 14.04, 32-bit                               
+//  Application:   2014 Summer Project                            
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define a table of load counters, one counter per real server. The 
+* table is placed in an anonymous shared mapping created before the
+* workers of the load balancer are forked, so every worker reads and
+* updates the same counters, and scheduling algorithms such as Least
+* Connection still see the global load of a real server.
+* Besides the global counters, every worker has its own row recording
+* how many requests it has sent to each real server. When a worker
+* dies or loses a connection, its part can be taken out of the global
+* counters.
+* The state of a real server, its load, max load, health and peak
+* EWMA of response time, is kept in a cache line of its own, so
+* workers updating different servers do not invalidate each other's
+* lines. A request is sent only after a slot is reserved by a compare
+* and swap which fails if the server is down or would go over its max
+* load minus the reserved capacity, so two workers which select the
+* same server at the same time cannot both take its last slot.
+* Every worker also writes the indexes of the servers it changes into
+* a log of its own, a ring written by that worker only. Other workers
+* read the logs from where they stopped, so they copy only the changed
+* servers into their own server tables. A worker which falls a whole
+* ring behind reads every server again.
+*
+* Required Files:
+* ===============
+* Interface.h, ErrorHandler.h, ErrorHandler.cpp, SharedLoadTable.h, 
+* SharedLoadTable.cpp, ServerTable.h, ServerTable.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* ver 1.1 : 16 Oct 2026
+* - cache line padded state of every server with max load, health and
+*   response time, and reservation of a slot by compare and swap
+* - setMaxLoad() when max load is changed by reloading configuration
+* - logs of changed servers, read by getChanges()
+* - setServer() keeps a max load which is already set
+*/
+
+#include <sys/mman.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include "../Common/ErrorHandler.h"
+#include "../SchedulingAlgorithms/ServerTable.h"
+
+
+//***********************************************************************
+// SharedLoadTable
+//
+// This class holds the current loads of real servers in shared memory.
+// A real server is identified by its index, which is the same in every
+// worker. The counters are atomic, so workers can update them without
+// a lock. A row of worker counters is only written by its own worker.
+//***********************************************************************
+
+class SharedLoadTable
+{
+public:
+    SharedLoadTable();
+    ~SharedLoadTable();
+    SharedLoadTable(const SharedLoadTable& ) = delete;
+    SharedLoadTable& operator=(const SharedLoadTable& ) = delete;
+
+    // map the table, must be invoked before fork()
+    int create(int server_count, int worker_count); 
+    void destroy(); // unmap the table
+
+    // A worker has connected to a real server, which is up. max_load
+    // is set if no worker has set it. Return the max load in the table,
+    // which may have been changed by reloading configuration.
+    int setServer(int index, int max_load);
+
+    int getLoad(int index) const;
+    int getMaxLoad(int index) const;
+    void setMaxLoad(int index, int max_load);
+    bool isHealthy(int index) const;
+    void setHealthy(int worker, int index, bool healthy);
+
+    // Take a slot of a real server for a request, if the load stays
+    // within max load - reserved and the server is up.
+    // return: the new load, or -1 if the server cannot take it
+    int reserve(int worker, int index, int reserved);
+    int increment(int worker, int index); // return the new load
+    int decrement(int worker, int index); // return the new load
+
+    // Add a sample of response time to the peak EWMA shared by the
+    // workers, and return the new average. Times are in microseconds.
+    double addLatency(int worker, int index, uint64_t rtt, uint64_t now);
+    void getLatency(int index, double& latency, uint64_t& latency_time) const;
+
+    // take the requests of a worker out of the global counters
+    void releaseServer(int worker, int index);
+    void releaseWorker(int worker);
+
+    // Append the indexes of the servers changed by the other workers
+    // since the last call to indexes. cursors keeps the place of the
+    // caller in every log, and is empty before the first call.
+    // return: false if changes may have been missed, e.g. at the first
+    //         call, then the caller must read every server
+    bool getChanges(int worker, std::vector<uint64_t>& cursors,
+                    std::vector<int>& indexes) const;
+private:
+    static const int CACHE_LINE_SIZE = 64;
+    static const uint64_t LOG_SIZE = 4096;
+
+    //*******************************************************************
+    // ServerState
+    //
+    // Shared state of a real server, in a cache line of its own. The
+    // response time is a double kept in the bits of an integer.
+    //*******************************************************************
+    struct alignas(CACHE_LINE_SIZE) ServerState
+    {
+        std::atomic<int> load;
+        std::atomic<int> max_load;
+        std::atomic<int> healthy;
+        std::atomic<uint64_t> latency;
+        std::atomic<uint64_t> latency_time;
+    };
+
+    //*******************************************************************
+    // ChangeLog
+    //
+    // Ring of the indexes of the servers a worker has changed. head is
+    // the number of changes ever written, the entry of change n is at
+    // n % LOG_SIZE.
+    //*******************************************************************
+    struct alignas(CACHE_LINE_SIZE) ChangeLog
+    {
+        std::atomic<uint64_t> head;
+        alignas(CACHE_LINE_SIZE) std::atomic<int> entries[LOG_SIZE];
+    };
+
+    std::atomic<int>& workerLoad(int worker, int index);
+    void logChange(int worker, int index);
+
+    ServerState *servers_;           // global state of every real server
+    std::atomic<int> *worker_loads_; // load sent by every worker
+    ChangeLog *logs_;                // log of every worker
+    int row_size_;                   // counters of a worker row, padded
+    int server_count_;
+    int worker_count_;
+    size_t map_size_;
+};
+
+
+#endif
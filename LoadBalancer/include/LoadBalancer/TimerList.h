@@ -0,0 +1,84 @@
+#ifndef TIMER_LIST_H
+#define TIMER_LIST_H
+/////////////////////////////////////////////////////////////////////
+//  TimerList.h - timers with the same time out on one timer fd
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the TimerList class, which manages a timer for each of many
+* file descriptors, e.g. idle time out of client connections. All the
+* timers have the same time out, so a timer started later always 
+* expires later. The timers are kept in a list in order of deadline:
+* a timer is started or restarted by moving it to the tail, and the
+* expired timers are taken from the head. Every operation is O(1),
+* and only one timer fd is needed, which is armed with the deadline
+* of the head.
+*
+* Required Files:
+* ===============
+* Interface.h, ErrorHandler.h, ErrorHandler.cpp, TimerList.h, 
+* TimerList.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "../Common/ErrorHandler.h"
+
+
+//***********************************************************************
+// TimerList
+//
+// The timer fd should be added to an epoll fd. When it is readable,
+// getExpired() returns the file descriptors whose timers have expired.
+//***********************************************************************
+
+class TimerList
+{
+public:
+    TimerList();
+    ~TimerList();
+    TimerList(const TimerList& ) = delete;
+    TimerList& operator=(const TimerList& ) = delete;
+
+    int init(time_t time_out); // create timer fd, time out in seconds
+    int getTimerfd() const;
+
+    void start(int fd);  // start or restart the timer of fd
+    void stop(int fd);   // stop the timer of fd, if there is one
+
+    // Read the timer fd, take the expired timers out of the list and 
+    // arm the timer fd for the next one.
+    void getExpired(std::vector<int>& expired_fds);
+private:
+    struct Timer
+    {
+        int fd;
+        struct timespec deadline;
+    };
+
+    void arm();
+
+    std::list<Timer> timers_; // in order of deadline
+    std::unordered_map<int, std::list<Timer>::iterator> timer_index_; // key is fd
+    int timer_fd_;
+    time_t time_out_;
+};
+
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+/////////////////////////////////////////////////////////////////////
+//  TimerWheel.h - many timers with different time outs on one timer fd
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the TimerWheel class, a hierarchical timing wheel, which
+* manages a timer for each of many small integer keys, e.g. slots of
+* the request table. Time is counted in ticks of a periodic timer fd.
+* The wheel has LEVELS levels of SLOTS slots. A slot of level 0 covers
+* one tick, a slot of level 1 covers SLOTS ticks, and so on. A timer
+* is put into the lowest level which can hold its deadline. Whenever
+* a level wraps around, the next slot of the level above is moved
+* down ("cascaded"), so every timer reaches level 0 in its last tick.
+* Timers are linked into the slots through an array indexed by key,
+* so starting and stopping a timer is O(1) and needs no allocation
+* once the array has grown. Deadlines are rounded up to whole ticks.
+* The timer fd ticks only while there are timers, so an idle process
+* is not woken up.
+*
+* Required Files:
+* ===============
+* Interface.h, ErrorHandler.h, ErrorHandler.cpp, TimerWheel.h,
+* TimerWheel.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <stdint.h>
+#include <vector>
+#include "../Common/ErrorHandler.h"
+
+
+//***********************************************************************
+// TimerWheel
+//
+// The timer fd should be added to an epoll fd. When it is readable,
+// getExpired() returns the data of the expired timers. If the timer
+// fd is read by somebody else (e.g. io_uring), the number of ticks
+// read is passed to advance() instead.
+//***********************************************************************
+
+class TimerWheel
+{
+public:
+    TimerWheel();
+    ~TimerWheel();
+    TimerWheel(const TimerWheel& ) = delete;
+    TimerWheel& operator=(const TimerWheel& ) = delete;
+
+    int init(unsigned tick_ms); // create timer fd, one tick in milliseconds
+    int getTimerfd() const;
+
+    // Start or restart the timer of key, which expires after time_out_ms
+    // milliseconds. data is returned when the timer expires.
+    void start(uint32_t key, uint64_t data, unsigned time_out_ms);
+    void stop(uint32_t key);   // stop the timer of key, if there is one
+    size_t size() const;       // number of running timers
+
+    // Read the timer fd and take the expired timers out of the wheel.
+    void getExpired(std::vector<uint64_t>& expired);
+
+    // Move the wheel ticks forward and take the expired timers out.
+    void advance(uint64_t ticks, std::vector<uint64_t>& expired);
+private:
+    static const unsigned LEVEL_BITS = 6;
+    static const uint32_t SLOTS = 1 << LEVEL_BITS; // slots of a level
+    static const unsigned LEVELS = 4;              // 2^24 ticks at most
+    static const uint32_t NIL = 0xffffffff;        // end of a slot list
+
+    struct Timer
+    {
+        uint64_t expire; // tick of deadline
+        uint64_t data;
+        uint32_t prev;   // key of the previous timer, or NIL
+        uint32_t next;   // key of the next timer, or NIL
+        uint32_t slot;   // index in heads_, NIL if not running
+    };
+
+    void link(uint32_t key);
+    void unlink(uint32_t key);
+    void cascade(unsigned level);
+    void arm(bool on);
+
+    std::vector<Timer> timers_;  // indexed by key
+    std::vector<uint32_t> heads_; // first timer of every slot
+    uint64_t current_;           // next tick to be run
+    size_t size_;
+    bool armed_;
+    int timer_fd_;
+    unsigned tick_ms_;
+};
+
+
+#endif
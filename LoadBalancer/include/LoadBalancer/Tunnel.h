@@ -0,0 +1,88 @@
+#ifndef TUNNEL_H
+#define TUNNEL_H
+/////////////////////////////////////////////////////////////////////
+//  Tunnel.h - TCP passthrough between a client and a real server
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the Tunnel class used in passthrough mode of the load balancer.
+* In this mode the load balancer does not parse HTTP messages. It only
+* chooses a real server for a new client connection, connects to the
+* server and moves bytes between the two sockets with splice(). Bytes
+* go through a pipe in kernel and are never copied into user space, and
+* there is no limit on the size of a message.
+*
+* Required Files:
+* ===============
+* Interface.h, Tunnel.h, Tunnel.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include "../Common/Interface.h"
+
+
+//***********************************************************************
+// Tunnel
+//
+// A tunnel owns a client socket, a socket connected to a real server,
+// and one pipe for each direction. Both sockets should be non-blocking
+// and added to epoll fd with EPOLLIN | EPOLLOUT | EPOLLET. Whenever
+// one of them is triggered, transfer() moves as many bytes as possible
+// in both directions.
+//***********************************************************************
+
+class Tunnel
+{
+public:
+    Tunnel(int client_fd, int server_fd, int server_index);
+    ~Tunnel(); // close sockets and pipes
+    Tunnel(const Tunnel& ) = delete;
+    Tunnel& operator=(const Tunnel& ) = delete;
+
+    int open(); // create the pipes
+
+    // Move bytes in both directions.
+    // return: -1 -- occur an error
+    //          0 -- the real server has closed and all bytes are sent
+    //          1 -- the tunnel is still working
+    int transfer();
+
+    int getClientfd() const;
+    int getServerfd() const;
+    int getServerIndex() const;
+private:
+    // one direction of the tunnel, from_fd -> pipe -> to_fd
+    struct Direction
+    {
+        int from_fd;
+        int to_fd;
+        int pipe_fd[2];
+        size_t pending; // bytes in the pipe
+        bool eof;       // from_fd has been closed by peer
+        bool shutdown;  // write end of to_fd has been shut down
+    };
+
+    int transferOneWay(Direction& direction);
+
+    Direction upstream_;   // client -> real server
+    Direction downstream_; // real server -> client
+    int server_index_;     // index of the real server in load table
+
+    static const size_t SPLICE_SIZE = 65536; // default capacity of a pipe
+};
+
+
+#endif
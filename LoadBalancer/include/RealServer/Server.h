@@ -17,32 +17,51 @@
 * balancer. If there are many requests, the server can fork some
 * more children to handle requests. While, the total number cannot
 * be more than max children provided by user.
+* The server accepts any number of connections from the load balancer
+* (one per balancer worker). Every connection has a ConnBuffer, where
+* partial reads are accumulated until a request is complete, and the
+* responses which cannot be written at once wait for EPOLLOUT. A 
+* request is passed to a child, and the child sends the response back
+* to the server, which writes it to the connection of the request.
 *
 * Required Files:
 * ===============
 * Interface.h, ErrorHandle.h, ErrorHandler.cpp, SocketCreator.h,
 * SocketCreator.cpp, HTTPBasic.h, HTTPWriter.cpp, ResponseMessage.cpp,
 * RequestMessage.cpp, HTTPReader.h, HTTPReader.cpp, ResponseHandler.cpp,
-* FdHandler.h, Server.h, Server.cpp
+* FdHandler.h, ConnBuffer.h, ConnBuffer.cpp, Server.h, Server.cpp
 *
 * Maintenance History:
 * ====================
 * ver 1.0 : 3 Aug 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - accept several load balancer connections, pass the connection fd
+*   to the child with each request
+* - send Request-ID back in 503 responses
+* - connections are read and written through ConnBuffer. Children send
+*   responses back to the server instead of writing the connection, so
+*   that responses on one connection are never interleaved
+* - requests and responses are sent with their real length, on the
+*   stream pipe behind a length prefix
+* - connections and timers of children are looked up in hash tables
+*   instead of fd_set, so fds above FD_SETSIZE can be used
 */
 
 #include <sys/epoll.h>
 #include <sys/timerfd.h> // timerfd_create()
-#include <sys/select.h> // fd_set
 #include <signal.h>
 #include <sys/signalfd.h> // signalfd
 #include <sys/wait.h>
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../Common/SocketCreator.h"
 #include "../Common/FdHandler.h"
+#include "../Common/ConnBuffer.h"
 #include "../HTTP/HTTPReader/HTTPReader.h"
 
 
@@ -57,7 +76,7 @@ static void getHeaderInfo(const HTTPMessage& msg,
     std::string& content,
     const std::string& target)
 {
-    std::string received_msg = msg.http_msg;
+    const std::string& received_msg = msg.http_msg;
     decltype(target.size()) found = received_msg.find(target);
     decltype(target.size()) index;
 
@@ -95,6 +114,16 @@ static void getSourcetPort(const HTTPMessage& msg, std::string& source_port)
     getHeaderInfo(msg, source_port, "Source-Port: ");
 }
 
+//-------------------------------------------------------------------
+// Get request ID by finding the content after "Request-ID: ".
+// The ID is added by the load balancer and must be sent back in the
+// response.
+//-------------------------------------------------------------------
+static void getRequestID(const HTTPMessage& msg, std::string& request_id)
+{
+    getHeaderInfo(msg, request_id, "Request-ID: ");
+}
+
 
 //***********************************************************************
 // Status
@@ -139,6 +168,8 @@ struct ChildInfo
     int child_timer_fd;       // timerfd of a child, only effective for 
                               // children forked when there are too many
                               // requests
+    int conn_fd;              // connection of the request being handled,
+                              // -1 if none, only used by the server
 };
 
 
@@ -169,7 +200,11 @@ public:
 
     void start(); // Entry point of a server
 
-    Status handleRequestFromClient(); 
+    Status acceptClient();
+    Status handleRequestFromClient(int trigger_fd); 
+    Status dispatchRequest(int conn_fd, HTTPMessage& recv_msg);
+    void flushClient(int conn_fd);
+    void closeClient(int conn_fd);
     Status handleResponseFromChild(int trigger_fd);
     Status handleChildTimeOut(int trigger_fd);
     Status serverSigHandler();
@@ -179,7 +214,6 @@ public:
 private:
     Status initEpollfd();
     Status initListenfd();
-    Status initClientfd();
     Status initSignalfd();
 
     void childWork(ChildInfo &child_info);
@@ -193,17 +227,16 @@ private:
     int children_exist_;    // number of children forked
     int children_free_;     // number of children whose status is FREE
     int listen_fd_;         // socket fd to listen to load balancer
-    int client_fd_;         // socket fd to communicate with load balancer
     int epoll_fd_;          // epoll fd to monitor other fds
     int signal_fd_;         // signal fd to receive signals
     int timer_fd_;          // timer fd to receive timer alarms
-    fd_set child_fds_;      // fd set of child spipes
-    fd_set timer_fds_;      // fd set of child timers
+    std::unordered_set<int> timer_fds_; // fds of child timers
     struct itimerspec ts_;  // time for a timer to alarm
     bool server_stop_;      // decide whether a server should exit or not
     char host_[NI_MAXHOST]; // server's IP address
     static int child_pfd_;  // used for childSigHandler to remove fd
     std::vector<ChildInfo> child_pool_; // vector to store children's information
+    std::unordered_map<int, ConnBuffer> conn_buffers_; // key is fds of load balancer connections
 
     static const char *PORT_NUM;
     static const int BACKLOG = 50;
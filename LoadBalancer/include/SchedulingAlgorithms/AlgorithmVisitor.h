@@ -0,0 +1,112 @@
+#ifndef ALGORITHM_VISITOR_H
+#define ALGORITHM_VISITOR_H
+/////////////////////////////////////////////////////////////////////
+//  AlgorithmVisitor.h - map a scheduling algorithm to its class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* This file defines visitAlgorithm(), which turns a SchedAlgorithm 
+* value into the type of its class, by calling a visitor with an
+* AlgorithmTag of that type. It is the only place where the values are
+* mapped to the classes. AlgorithmSelector creates its algorithm by it,
+* and a program which needs the type itself, e.g. to call an algorithm
+* directly, uses it the same way:
+*
+*     struct Run
+*     {
+*         template <typename T> void operator()(AlgorithmTag<T>)
+*         {
+*             T sched_algo;
+*             ... sched_algo.selectServer() ...
+*         }
+*     };
+*     visitAlgorithm(sched_type, Run());
+*
+* Required Files:
+* ===============
+* SchedAlgorithms.h, AlgorithmVisitor.h and the files needed by
+* SchedAlgorithms.h
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* - StaticSelector is removed, the load balancer selects through
+*   AlgorithmSelector. The file is renamed from StaticSelector.h
+*/
+
+#include "SchedAlgorithms.h"
+
+
+//***********************************************************************
+// AlgorithmTag
+//
+// An empty struct which carries the type of an algorithm to a visitor.
+//***********************************************************************
+
+template <typename Algorithm>
+struct AlgorithmTag
+{
+    typedef Algorithm type;
+};
+
+
+//-------------------------------------------------------------------
+// Call visitor with the tag of the class of sched_type.
+// return: false if sched_type is not known, and visitor is not called
+//-------------------------------------------------------------------
+template <typename Visitor>
+bool visitAlgorithm(SchedAlgorithm sched_type, Visitor&& visitor)
+{
+    switch (sched_type)
+    {
+    case Round_Robin:
+        visitor(AlgorithmTag<SchedRR>());
+        return true;
+    case Weighted_Round_Robin:
+        visitor(AlgorithmTag<SchedWRR>());
+        return true;
+    case Least_Connection:
+        visitor(AlgorithmTag<SchedLC>());
+        return true;
+    case Weighted_Least_Connection:
+        visitor(AlgorithmTag<SchedWLC>());
+        return true;
+    case Destination_Hashing:
+        visitor(AlgorithmTag<SchedDH>());
+        return true;
+    case Source_Hashing:
+        visitor(AlgorithmTag<SchedSH>());
+        return true;
+    case Power_Of_Two_Choices:
+        visitor(AlgorithmTag<SchedP2C>());
+        return true;
+    case Maglev_Hashing:
+        visitor(AlgorithmTag<SchedMaglev>());
+        return true;
+    case Peak_EWMA:
+        visitor(AlgorithmTag<SchedPeakEWMA>());
+        return true;
+    case Shortest_Expected_Delay:
+        visitor(AlgorithmTag<SchedSED>());
+        return true;
+    case Never_Queue:
+        visitor(AlgorithmTag<SchedNQ>());
+        return true;
+    case Locality_Based_Least_Connection:
+        visitor(AlgorithmTag<SchedLBLC>());
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+#endif
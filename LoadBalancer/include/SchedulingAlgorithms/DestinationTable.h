@@ -0,0 +1,100 @@
+#ifndef DESTINATION_TABLE_H
+#define DESTINATION_TABLE_H
+/////////////////////////////////////////////////////////////////////
+//  DestinationTable.h - servers assigned to destinations, which
+//                       expire when they are not used
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the DestinationTable class, which maps a destination, e.g. the
+* URL of a request, to the real server assigned to it. It is a hash
+* table with open addressing and linear probing in an array of a fixed
+* power of two size, so it allocates nothing after it is created. The
+* destinations are kept as 64-bit hashes instead of strings.
+* Entries are taken out by shifting the following entries of the same
+* run back, so there are no deleted marks which make lookups longer.
+* A clock hand goes round the array a few slots at every lookup, and
+* takes out the entries which have not been used for expire time. When
+* the table is full, the hand gives every entry used since it passed
+* last time a second chance, and takes out the first entry which was
+* not, an approximation of the least recently used one.
+*
+* Required Files:
+* ===============
+* DestinationTable.h, DestinationTable.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+
+//***********************************************************************
+// DestinationTable
+//
+// A server is recorded by its index and fd in the server table, so an
+// entry of a server which has been removed, or whose slot is used by
+// another server, can be recognized by the caller.
+//***********************************************************************
+
+class DestinationTable
+{
+public:
+    struct Entry
+    {
+        uint64_t hash;      // hash of destination, 0 if the slot is empty
+        int index;          // index of the server in the server table
+        int fd;             // fd of the server
+        time_t last_used;
+        bool referenced;    // used since the clock hand passed
+    };
+
+    // capacity is rounded up to a power of two.
+    explicit DestinationTable(size_t capacity);
+
+    void setExpireTime(time_t expire_time) { expire_time_ = expire_time; }
+    void clear();
+
+    // Return the entry of a destination, or nullptr. The entry is marked
+    // as used at now.
+    Entry* find(uint64_t hash, time_t now);
+
+    // Assign a server to a destination.
+    void set(uint64_t hash, int index, int fd, time_t now);
+
+    size_t size() const { return size_; }
+
+    // Hash of a destination, never 0.
+    static uint64_t hashKey(const std::string& key);
+private:
+    // Slots the clock hand passes at every lookup
+    static const size_t SWEEP_STEP = 4;
+
+    void erase(size_t slot);
+    void sweep(time_t now);
+    void evict();
+    size_t home(uint64_t hash) const { return hash & mask_; }
+
+    std::vector<Entry> slots_;
+    size_t mask_;
+    size_t size_;
+    size_t max_size_;   // size at which the table is full
+    size_t hand_;       // slot of the clock hand
+    time_t expire_time_;
+};
+
+
+#endif
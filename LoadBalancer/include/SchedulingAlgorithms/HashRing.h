@@ -0,0 +1,97 @@
+#ifndef HASH_RING_H
+#define HASH_RING_H
+/////////////////////////////////////////////////////////////////////
+//  HashRing.h - a consistent hash ring of real servers
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the HashRing class, a Ketama style consistent hash ring of the
+* servers in a ServerTable. Every server owns a number of points on a
+* ring of 32-bit hashes ("virtual nodes"), proportional to its max
+* load. The points are hashed from the address and port of the server,
+* so a server gets the same points whatever the other servers are.
+* A key is mapped to the first point at or after its hash, going round
+* the ring. When a server is added or removed, only the keys mapped to
+* its points move, instead of nearly all of them with hash % size.
+* The points are kept in a sorted array, so a lookup is a binary
+* search. Adding a server merges its sorted points into the array, and
+* removing a server takes its points out, without sorting the ring
+* again.
+*
+* Required Files:
+* ===============
+* ServerTable.h, ServerTable.cpp, HashRing.h, HashRing.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <stdint.h>
+#include <vector>
+#include "ServerTable.h"
+
+
+//***********************************************************************
+// HashRing
+//
+// lookup() returns the position of the point a key is mapped to. A
+// caller which cannot use that server walks on to the next positions,
+// which belong to the servers that would take the key if the server
+// were removed.
+//***********************************************************************
+
+class HashRing
+{
+public:
+    HashRing();
+
+    void setServerTable(const ServerTable *server_table);
+    void clear();
+
+    void add(int index);    // put the points of a server on the ring
+    void remove(int index); // take the points of a server off the ring
+
+    bool empty() const { return points_.empty(); }
+    size_t size() const { return points_.size(); }
+
+    // Position of the first point at or after hash, going round.
+    // The ring must not be empty.
+    size_t lookup(uint32_t hash) const;
+    size_t next(size_t pos) const { return (pos + 1 == points_.size()) ? 0 : pos + 1; }
+    int getServer(size_t pos) const { return points_[pos].index; }
+
+    // Spread the bits of a key, e.g. an IPv4 address, over the ring.
+    static uint32_t hashKey(uint32_t key);
+private:
+    // Number of points for each unit of max load, and the bounds of
+    // the number of points of one server.
+    static const int POINTS_PER_LOAD = 16;
+    static const int MIN_POINTS = 16;
+    static const int MAX_POINTS = 1024;
+
+    struct Point
+    {
+        uint32_t hash;
+        int index;   // index of the server in the table
+
+        bool operator<(const Point& other) const
+        {
+            return hash < other.hash || (hash == other.hash && index < other.index);
+        }
+    };
+
+    std::vector<Point> points_; // sorted by hash
+    const ServerTable *server_table_;
+};
+
+
+#endif
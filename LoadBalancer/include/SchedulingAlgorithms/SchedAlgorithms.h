@@ -13,53 +13,96 @@
 /*
 * File Description:
 * ==================
-* This class defines nine classes:
+* This class defines sixteen classes:
 * (1) AbstractSchedAlgorithms, base class of other scheduling algorithms.
 * (2) SchedRR, Round Robin scheduling algorithm.
 * (3) SchedWRR, Weighted Round Robin scheduling algorithm.
-* (4) SchedLC, Least Connection scheduling algorithm.
-* (5) SchedWLC, weighted Least Connection scheduling algorithm.
-* (6) SchedDH, Destination Hashing scheduling algorithm.
-* (7) SchedSH, Source Hashing scheduling algorithm.
-* (8) AlgorithmSelector, a simple factory and also a delegate to produce
+* (4) SchedHeap, base class of the algorithms on a heap of servers.
+* (5) SchedLC, Least Connection scheduling algorithm.
+* (6) SchedWLC, weighted Least Connection scheduling algorithm.
+* (7) SchedHashing, base class of SchedDH and SchedSH.
+* (8) SchedDH, Destination Hashing scheduling algorithm.
+* (9) SchedSH, Source Hashing scheduling algorithm.
+* (10) SchedP2C, Power of Two Choices scheduling algorithm.
+* (11) SchedMaglev, Maglev Hashing scheduling algorithm.
+* (12) SchedPeakEWMA, Peak EWMA of latency scheduling algorithm.
+* (13) SchedSED, Shortest Expected Delay scheduling algorithm.
+* (14) SchedNQ, Never Queue scheduling algorithm.
+* (15) SchedLBLC, Locality-Based Least Connection scheduling algorithm.
+* (16) AlgorithmSelector, a simple factory and also a delegate to produce
 *     an object of a scheduling algorithm.
+* All the scheduling algorithms read the real servers from a ServerTable
+* owned by the load balancer.
 *
 * Required Files:
 * ===============
-* Interface.h ErrorHandler.h, ErrorHandler.cpp, SchedRR.cpp, SchedWRR.cpp,
-* SchedLC.cpp, SchedWLC.cpp, SchedDH.cpp, SchedSH.cpp, AlgorithmSelector.cpp
+* Interface.h ErrorHandler.h, ErrorHandler.cpp, ServerTable.h, 
+* ServerTable.cpp, ServerHeap.h, ServerHeap.cpp, HashRing.h, HashRing.cpp,
+* SchedRR.cpp, SchedWRR.cpp, SchedHeap.cpp, SchedLC.cpp, SchedWLC.cpp,
+* SchedHashing.cpp, SchedDH.cpp, SchedSH.cpp, SchedP2C.cpp, SchedMaglev.cpp,
+* SchedPeakEWMA.cpp, SchedSED.cpp, SchedNQ.cpp, DestinationTable.h,
+* DestinationTable.cpp, SchedLBLC.cpp, AlgorithmSelector.cpp
 *
 * Maintenance History:
 * ====================
 * ver 1.0 : 1 Aug 2014
 * - first release
+* ver 1.1 : 16 Oct 2026
+* - scheduling algorithms read a shared ServerTable and are told about
+*   changes of loads, instead of copying the server pool before every
+*   selection. RealServer is moved to ServerTable.h
+* - SchedRR moves a cursor over a dense array of servers in O(1), and
+*   SchedWRR is the smooth weighted round robin of nginx. Both have no
+*   static state and can be invoked by several threads. SchedWRR 
+*   builds its round under a mutex and swaps it in atomically
+* - SchedLC and SchedWLC keep the servers with capacity in an indexed
+*   heap, updated in O(log n) when a load changes. A saturated server
+*   is never selected
+* - SchedP2C, power of two choices: two random servers with capacity
+*   are compared, and the one with lower load is selected
+* - SchedDH and SchedSH map addresses by a consistent hash ring in
+*   SchedHashing instead of hash % number of servers, so adding or
+*   removing a server moves only the clients of that server
+* - AlgorithmSelector keeps the type it is constructed with, and passes
+*   the handle IP to any algorithm
+* - SchedMaglev, Maglev hashing by a lookup table, which is built by a
+*   thread and swapped in atomically
+* - SchedHashing bounds loads of servers to (1 + epsilon) times the
+*   average, if setLoadBound() is invoked
+* - SchedPeakEWMA selects by peak EWMA of response time * (current
+*   load + 1)
+* - SchedSED and SchedNQ, Shortest Expected Delay and Never Queue of
+*   LVS, on heaps of servers
+* - SchedLBLC assigns URLs to servers, with a WLC fallback. The URL of
+*   a request is given by setHandleURL()
+* - concrete algorithms are final. AlgorithmSelector creates them by
+*   visitAlgorithm() in AlgorithmVisitor.h
+* - RESERVED_CAPACITY is public, the load balancer reserves slots of
+*   servers with it
+* - AlgorithmSelector::setSchedType() after selectAlgorithm() builds a
+*   new algorithm from the server table and deletes the old one, which
+*   was leaked. The load bound and expire time are kept for it
+* - SchedHeap keeps the heap of SchedLC, SchedWLC, SchedPeakEWMA,
+*   SchedSED, SchedNQ and SchedLBLC, which share the comparators
 */
 
 
 #include <iostream>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#include <memory>
+#include <pthread.h>
 #include <netdb.h>
 #include <arpa/inet.h>
 
 #include "../Common/ErrorHandler.h"
-
-
-//***********************************************************************
-// RealServer
-//
-// A struct that represents a real server. The struct holds a real server's
-// IP address, port number, max load and current load. This struct is used
-// in a load balancer to schedule.
-//***********************************************************************
-
-struct RealServer
-{
-    std::string address;
-    std::string port_num;
-    int max_load;
-    int cur_load;
-};
+#include "ServerTable.h"
+#include "ServerHeap.h"
+#include "HashRing.h"
+#include "DestinationTable.h"
 
 
 //***********************************************************************
@@ -75,34 +118,75 @@ enum SchedAlgorithm { Round_Robin,
                       Least_Connection, 
                       Weighted_Least_Connection, 
                       Destination_Hashing, 
-                      Source_Hashing };
+                      Source_Hashing,
+                      Power_Of_Two_Choices,
+                      Maglev_Hashing,
+                      Peak_EWMA,
+                      Shortest_Expected_Delay,
+                      Never_Queue,
+                      Locality_Based_Least_Connection };
 
 
 //***********************************************************************
 // AbstractSchedAlgorithms
 //
 // The class defines an interface of a scheduling algorithm class.
+// A scheduling algorithm is a listener of its server table. Algorithms
+// which keep their own index of the servers override the callbacks.
 //***********************************************************************
 
-class AbstractSchedAlgorithms
+class AbstractSchedAlgorithms : public ServerTable::Listener
 {
 public:
-    using SchedMap = std::unordered_map<int, RealServer>;
+    AbstractSchedAlgorithms() : server_table_(nullptr) {}
+    virtual ~AbstractSchedAlgorithms();
+    AbstractSchedAlgorithms(const AbstractSchedAlgorithms& ) = delete;
+    AbstractSchedAlgorithms& operator=(const AbstractSchedAlgorithms& ) = delete;
 
-    AbstractSchedAlgorithms(){};
-    virtual ~AbstractSchedAlgorithms(){};
     virtual int selectServer() = 0;
-    virtual void setSchedMap(const SchedMap&) = 0;
     virtual void setHandleIP(const std::string&){}
-protected:
-    // Reserved capacity of a server to avoid over load.
-    static const int RESERVED_CAPACITY = 1;
+    virtual void setLoadBound(double){}
+    virtual void setHandleURL(const std::string&){}
+    virtual void setExpireTime(int){}
 
-    // These are the hash constants used in Destination Hashing
-    // and Source Hashing algorithms.
-    static const int HASH_TAB_BITS = 12;
-    static const int HASH_TAB_SIZE = 1 << HASH_TAB_BITS;
-    static const int HASH_TAB_MASK = HASH_TAB_SIZE - 1;
+    // Read servers from server_table, and listen to its changes.
+    void setServerTable(ServerTable *server_table);
+
+    // Reserved capacity of a server to avoid over load. The load
+    // balancer reserves slots of servers with the same limit.
+    static const int RESERVED_CAPACITY = 1;
+protected:
+    // Take the servers already in a new server table. By default,
+    // serverAdded() is invoked for each of them. An algorithm which 
+    // builds its data from all the servers at once overrides it.
+    virtual void loadTable();
+
+    // Change of the number of servers with capacity caused by a change
+    // of load: -1, 0 or 1
+    int capacityChange(int index, int old_load) const
+    {
+        const RealServer& server = server_table_->get(index);
+        bool before = old_load < server.max_load - RESERVED_CAPACITY;
+        return static_cast<int>(hasCapacity(server)) - static_cast<int>(before);
+    }
+
+    // Whether a server can take one more request
+    static bool hasCapacity(const RealServer& server)
+    {
+        return server.cur_load < server.max_load - RESERVED_CAPACITY;
+    }
+
+    // Change an IPv4 address in dotted format into an unsigned integer
+    // in network byte order. Return false if it is not correct.
+    static bool parseIPv4(const std::string& ip, uint32_t& addr);
+
+    // Whether the server at index is in the table and has capacity
+    bool isAvailable(int index) const
+    {
+        return server_table_->inUse(index) && hasCapacity(server_table_->get(index));
+    }
+
+    ServerTable *server_table_;
 };
 
 
@@ -112,18 +196,31 @@ protected:
 // This class defines operations of Round Robin scheduling algorithm.
 // In Round Robin algorithm, the load balancer sends each request to
 // the real servers one by one, sequentially.
+// The indexes of the servers are kept in a dense array, which is built
+// again only when a server is added or removed, and a cursor moves over
+// it. The number of servers with capacity is counted from load change
+// events, so the algorithm returns at once when all are saturated.
+// The cursor is atomic, so selectServer() can be invoked by several
+// threads at the same time. Changes of the server table must not run
+// at the same time as selectServer().
 //***********************************************************************
 
-class SchedRR : public AbstractSchedAlgorithms
+class SchedRR final : public AbstractSchedAlgorithms
 {
 public:
-    SchedRR(){};
-    SchedRR(SchedMap& sched_map)
-        : sched_map_(sched_map){}
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
+    SchedRR() : next_(0), available_(0) {}
     int selectServer();
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
 private:
-    SchedMap sched_map_;
+    void loadTable();
+    void build();
+
+    std::vector<int> servers_;      // indexes of servers in the table
+    std::atomic<unsigned> next_;    // cursor over servers_
+    std::atomic<int> available_;    // servers with capacity
 };
 
 
@@ -135,19 +232,75 @@ private:
 // algorithm is that, there is a capacity for every real server, representing
 // by max load in this design. When send requests to next server, load
 // balancer should also consider weight.
+// This is the smooth weighted round robin of nginx: every round, each
+// server's current weight is increased by its weight, the server with
+// the largest current weight is selected, and its current weight is 
+// decreased by the total weight. So the picks of a heavy server are
+// spread over the round instead of coming in a burst. The order of one
+// round is computed once for a new table, and at the first selection
+// after servers are added or removed. Selection moves an atomic cursor
+// over it as in SchedRR.
+// The round is built under a mutex by the first thread which finds it
+// stale, while other threads which find it stale wait for it. It is
+// swapped in atomically, so a selection already going on keeps the
+// round it has loaded.
 //***********************************************************************
 
-class SchedWRR : public AbstractSchedAlgorithms
+class SchedWRR final : public AbstractSchedAlgorithms
 {
 public:
-    SchedWRR(){}
-    SchedWRR(SchedMap& sched_map)
-        : sched_map_(sched_map){}
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
+    SchedWRR();
+    ~SchedWRR();
     int selectServer();
-    
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
 private:
-    SchedMap sched_map_;
+    void loadTable();
+    void build();
+
+    // A round longer than this is made shorter by scaling the weights
+    // down, so that building it stays cheap with many servers.
+    static const int MAX_ROUND_SIZE = 8192;
+
+    // indexes of servers in one round, read and swapped atomically
+    std::shared_ptr<const std::vector<int> > round_;
+    std::atomic<unsigned> next_;    // cursor over round_
+    std::atomic<int> available_;    // servers with capacity
+    std::atomic<bool> stale_;       // servers changed since round_ was built
+    pthread_mutex_t mtx_;           // held while round_ is built
+};
+
+
+//***********************************************************************
+// SchedHeap
+//
+// This class is the base of the algorithms which select the least
+// server by an order, given by the comparator passed to the
+// constructor. The servers with capacity are kept in a heap in that
+// order. A server is moved in the heap when its load changes, and
+// taken out when it becomes saturated, so the top of the heap is the
+// answer.
+//***********************************************************************
+
+class SchedHeap : public AbstractSchedAlgorithms
+{
+public:
+    explicit SchedHeap(ServerHeap::Less less) : heap_(less) {}
+    int selectServer();
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
+protected:
+    void loadTable();
+
+    // Keep a server in the heap at its place if it is available, or
+    // take it out.
+    virtual void refresh(int index);
+
+    ServerHeap heap_; // servers with capacity
 };
 
 
@@ -158,18 +311,14 @@ private:
 // In Least Connection algorithm, the load balancer sends each request to
 // the real server with least connections, which is represented by current
 // load in this design.
+// The servers with capacity are kept in a heap ordered by current load.
 //***********************************************************************
 
-class SchedLC : public AbstractSchedAlgorithms
+class SchedLC final : public SchedHeap
 {
 public:
-    SchedLC(){}
-    SchedLC(SchedMap& sched_map)
-        : sched_map_(sched_map){}
-    int selectServer();
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
-private:
-    SchedMap sched_map_;
+    SchedLC() : SchedHeap(lessLoad) {}
+    static bool lessLoad(const RealServer& a, const RealServer& b);
 };
 
 
@@ -181,18 +330,69 @@ private:
 // algorithm is similar to the difference between Round Robin and Weighted
 // Round Robin. That is when load balancer sends requests, it should also
 // consider capacity, and send request to min(connection / capacity).
+// Same as SchedLC, the servers with capacity are kept in a heap, which
+// is ordered by current load / max load.
 //***********************************************************************
 
-class SchedWLC : public AbstractSchedAlgorithms
+class SchedWLC final : public SchedHeap
 {
 public:
-    SchedWLC(){}
-    SchedWLC(SchedMap& sched_map)
-        : sched_map_(sched_map){}
-    int selectServer();
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
+    SchedWLC() : SchedHeap(lessWeightedLoad) {}
+    static bool lessWeightedLoad(const RealServer& a, const RealServer& b);
+};
+
+
+//***********************************************************************
+// SchedHashing
+//
+// This class is the base of Destination Hashing and Source Hashing
+// algorithms. An IPv4 address is mapped to a server by a consistent
+// hash ring, so when a server is added or removed, only the addresses
+// mapped to that server move to other servers, and the other clients
+// keep their servers and the data cached there.
+// When the server an address is mapped to is saturated, the next
+// servers on the ring are tried, so an address always goes to the same
+// server while the load does not change.
+// With bounded loads (epsilon >= 0), a server is also passed over when
+// its load would go beyond (1 + epsilon) times the average load, which
+// is weighted by max load as the ring is. So a hot address cannot make
+// one server much busier than the others, and the overflow goes to the
+// next servers on the ring, the same ones every time.
+// A walk tries every server at most once, so it returns at once when
+// all servers are saturated, and after n servers when all are over
+// the bound.
+//***********************************************************************
+
+class SchedHashing : public AbstractSchedAlgorithms
+{
+public:
+    SchedHashing()
+        : epsilon_(-1.0), total_load_(0), total_weight_(0),
+          server_count_(0), available_(0), visit_(0) {}
+    void setLoadBound(double epsilon) { epsilon_ = epsilon; }
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
+protected:
+    // Select a server for an IPv4 address in dotted format.
+    int selectByIP(const std::string& ip);
 private:
-    SchedMap sched_map_;
+    void loadTable();
+    bool underBound(int index) const;
+    static int weight(const RealServer& server);
+
+    HashRing ring_;
+    double epsilon_;         // negative if loads are not bounded
+    long long total_load_;   // current loads of servers in the table
+    long long total_weight_; // max loads of servers in the table
+    int server_count_;       // servers on the ring
+    int available_;          // servers with capacity
+
+    // tried_[index] is visit_ if the server has been tried by the
+    // current walk round the ring.
+    std::vector<unsigned> tried_;
+    unsigned visit_;
 };
 
 
@@ -207,18 +407,15 @@ private:
 // the cache server and send requests to original server directly.
 //***********************************************************************
 
-class SchedDH : public AbstractSchedAlgorithms
+class SchedDH final : public SchedHashing
 {
 public:
     SchedDH(){}
-    SchedDH(SchedMap& sched_map, std::string dest_ip)
-        : sched_map_(sched_map), dest_ip_(dest_ip) {}
+    SchedDH(std::string dest_ip)
+        : dest_ip_(dest_ip) {}
     int selectServer();
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
     void setHandleIP(const std::string& dest_ip) { dest_ip_ = dest_ip; }
 private:
-    unsigned hashkey(unsigned int hashed_ip);
-    SchedMap sched_map_;
     std::string dest_ip_;
 };
 
@@ -231,19 +428,245 @@ private:
 // algorithm, only replacing destination IP address with source IP address. 
 //***********************************************************************
 
-class SchedSH : public AbstractSchedAlgorithms
+class SchedSH final : public SchedHashing
 {
 public:
     SchedSH(){}
-    SchedSH(SchedMap& sched_map, std::string source_ip)
-        : sched_map_(sched_map), source_ip_(source_ip) {}
+    SchedSH(std::string source_ip)
+        : source_ip_(source_ip) {}
+    int selectServer();
+    void setHandleIP(const std::string& source_ip) { source_ip_ = source_ip; }
+private:
+    std::string source_ip_;
+};
+
+
+//***********************************************************************
+// SchedP2C
+//
+// This class defines operations of Power of Two Choices scheduling
+// algorithm. The load balancer picks two different servers with
+// capacity at random, and sends the request to the one with lower load.
+// If weighted is true, loads are compared as current load / max load.
+// Compared with Least Connection, it needs no ordered index, and when
+// several workers select from loads which are not up to date, they do
+// not all send their requests to the same least loaded server.
+// The indexes of servers with capacity are kept in a dense array, and
+// the position of every server in it in an array indexed by server
+// index, so a server becoming saturated or available is taken out or
+// put in in O(1), and a selection is O(1).
+//***********************************************************************
+
+class SchedP2C final : public AbstractSchedAlgorithms
+{
+public:
+    explicit SchedP2C(bool weighted = true);
+    int selectServer();
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
+private:
+    void loadTable();
+    void refresh(int index);
+    void insert(int index);
+    void erase(int index);
+    bool lessLoad(int a, int b) const; // compare servers at two indexes
+    uint32_t random();
+
+    bool weighted_;
+    uint64_t seed_;                 // state of the xorshift generator
+    std::vector<int> available_;    // indexes of servers with capacity
+    std::vector<int> position_;     // position in available_, -1 if absent
+};
+
+
+//***********************************************************************
+// SchedMaglev
+//
+// This class defines operations of Maglev Hashing scheduling algorithm.
+// A lookup table of TABLE_SIZE entries, a prime, maps the hash of the
+// source IP address to a server, so a selection is one array index.
+// Every server has its own permutation of the entries, given by an
+// offset and a skip hashed from its address and port, and the servers
+// take turns to claim their next free entry until the table is full.
+// Turns are given in proportion to max load. So every server owns
+// nearly the same share of the table per unit of max load, and when a
+// server is removed, most entries of other servers do not change.
+// When the server of an entry is saturated, the following entries are
+// tried.
+// Building a table costs O(TABLE_SIZE), so it is not done in the event
+// loop. A change of servers hands a copy of them to a builder thread,
+// which builds a new table and swaps it in atomically. The old table is
+// used until then; its entries of a removed server are skipped. Only
+// a table replacing one without any current server is built at once,
+// so that there is a table as soon as there is a server. Tables are
+// numbered by their requests, and an older one is never swapped in
+// over a newer one.
+//***********************************************************************
+
+class SchedMaglev final : public AbstractSchedAlgorithms
+{
+public:
+    SchedMaglev();
+    ~SchedMaglev();
     int selectServer();
-    void setSchedMap(const SchedMap& sched_map) { sched_map_ = sched_map; }
     void setHandleIP(const std::string& source_ip) { source_ip_ = source_ip; }
+
+    void serverAdded(int index);
+    void serverRemoved(int index);
+    void loadChanged(int index, int old_load);
 private:
-    unsigned hashkey(unsigned int hashed_ip);
-    SchedMap sched_map_;
+    static const int TABLE_SIZE = 65537;
+
+    struct Backend
+    {
+        int index;         // index in the server table
+        int fd;
+        int weight;        // max load
+        std::string name;  // address:port
+    };
+
+    struct Table
+    {
+        unsigned long generation; // number of the request it is built for
+        std::vector<int> entries; // server index of every entry
+        std::vector<int> fds;     // fd of every server index
+    };
+
+    void loadTable();
+    void requestBuild();
+    void storeTable(std::shared_ptr<const Table> table);
+    static std::shared_ptr<const Table> build(const std::vector<Backend>& backends,
+                                              unsigned long generation);
+    static void* runBuilder(void *arg);
+
     std::string source_ip_;
+    std::shared_ptr<const Table> table_; // read and swapped atomically
+    std::atomic<int> available_;         // servers with capacity
+    unsigned long generation_;           // number of the last request
+
+    // builder thread
+    pthread_t builder_;
+    bool builder_started_;
+    pthread_mutex_t mtx_;
+    pthread_cond_t cond_;
+    std::vector<Backend> pending_;       // servers of the next table
+    unsigned long pending_generation_;   // number of its request
+    bool build_pending_;
+    bool stop_;
+};
+
+
+//***********************************************************************
+// SchedPeakEWMA
+//
+// This class defines operations of Peak EWMA scheduling algorithm. The
+// load balancer measures the response time of every real server, and
+// keeps its peak EWMA in the server table. The request is sent to the
+// server with the least latency * (current load + 1), which is the
+// expected time to finish the request if the requests in flight are
+// answered one by one. A server which slows down, e.g. in a pause of
+// garbage collection, gets fewer requests at once, even while its
+// current load is not higher than others.
+// A server without any response yet counts as 1 microsecond, so new
+// servers are tried first, in order of current load.
+// Same as SchedWLC, the servers with capacity are kept in a heap, and
+// a server is moved when its load or its latency changes.
+//***********************************************************************
+
+class SchedPeakEWMA final : public SchedHeap
+{
+public:
+    SchedPeakEWMA() : SchedHeap(lessCost) {}
+    void latencyChanged(int index);
+private:
+    static double cost(const RealServer& server);
+    static bool lessCost(const RealServer& a, const RealServer& b);
+};
+
+
+//***********************************************************************
+// SchedSED
+//
+// This class defines operations of Shortest Expected Delay scheduling
+// algorithm. The request is sent to the server with the least
+// (current load + 1) / max load, which is the expected delay of the
+// request if a server finishes requests at a speed in proportion to
+// its max load. Different from Weighted Least Connection, the request
+// being scheduled is counted, so an idle slow server is not selected
+// before a fast server which has only a few requests.
+// Same as SchedWLC, the servers with capacity are kept in a heap.
+//***********************************************************************
+
+class SchedSED final : public SchedHeap
+{
+public:
+    SchedSED() : SchedHeap(lessDelay) {}
+    static bool lessDelay(const RealServer& a, const RealServer& b);
+};
+
+
+//***********************************************************************
+// SchedNQ
+//
+// This class defines operations of Never Queue scheduling algorithm.
+// If there is an idle server, the request is sent to it, so the request
+// never waits behind another one. Among idle servers, the one with the
+// largest max load is selected. If no server is idle, the server is
+// selected as in Shortest Expected Delay algorithm.
+// The idle servers are kept in a heap of their own, ordered in the same
+// way by SchedSED::lessDelay(), which puts the largest max load first
+// among idle servers, so both cases are read from the top of a heap.
+//***********************************************************************
+
+class SchedNQ final : public SchedHeap
+{
+public:
+    SchedNQ() : SchedHeap(SchedSED::lessDelay), idle_(SchedSED::lessDelay) {}
+    int selectServer();
+
+    void serverRemoved(int index);
+private:
+    void loadTable();
+    void refresh(int index);
+
+    ServerHeap idle_; // servers without any request
+};
+
+
+//***********************************************************************
+// SchedLBLC
+//
+// This class defines operations of Locality-Based Least Connection
+// scheduling algorithm. A destination, the URL of a request or the IP
+// address of a client if there is no URL, is assigned to a server,
+// and later requests of the destination are sent to the same server,
+// so repeated requests of one file hit the cache of one real server.
+// If the assigned server is saturated, or it is busy at more than half
+// of its max load while another server is at less than a quarter of
+// its own, a server is selected as in Weighted Least Connection and
+// assigned to the destination instead.
+// The assignments are kept in a DestinationTable, and expire when a
+// destination is not requested for expire time.
+//***********************************************************************
+
+class SchedLBLC final : public SchedHeap
+{
+public:
+    SchedLBLC();
+    int selectServer();
+    void setHandleIP(const std::string& ip) { key_ = ip; }
+    void setHandleURL(const std::string& url) { key_ = url; }
+    void setExpireTime(int seconds);
+private:
+    static const size_t TABLE_CAPACITY = 16384;
+
+    void loadTable();
+    bool isOverloaded(int index) const;
+
+    std::string key_;          // destination of the request
+    DestinationTable table_;
 };
 
 
@@ -259,8 +682,6 @@ private:
 class AlgorithmSelector
 {
 public:
-    using SchedMap = std::unordered_map<int, RealServer>;
-
     AlgorithmSelector(SchedAlgorithm sched_type);
     ~AlgorithmSelector();
 
@@ -268,17 +689,28 @@ public:
     void selectAlgorithm();
 
     // set and get functions
-    void setSchedMap(const SchedMap& sched_map);
-    void setSchedType(const SchedAlgorithm sched_type);
+    void setServerTable(ServerTable *server_table);
+
+    // Change the algorithm. If one has been selected, a new one is
+    // built and replaces it. Return false if the type is not known.
+    bool setSchedType(const SchedAlgorithm sched_type);
     const SchedAlgorithm getSchedType();
     void setHandleIP(const std::string& handle_ip);
+    void setLoadBound(double epsilon);
+    void setHandleURL(const std::string& url);
+    void setExpireTime(int seconds);
     const AbstractSchedAlgorithms* getSchedAlgoPtr();
 
     // Invoke a scheduling algorithm's selectServer() function
     int selectServer();
 private:
+    void configure(AbstractSchedAlgorithms *sched_algo);
+
     SchedAlgorithm sched_type_;
     AbstractSchedAlgorithms *sched_algo_;
+    ServerTable *server_table_;
+    double epsilon_;    // load bound given to the algorithm
+    int expire_time_;   // expire time given to the algorithm, 0 if not given
 };
 
 
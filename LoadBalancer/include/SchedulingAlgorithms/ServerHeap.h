@@ -0,0 +1,77 @@
+#ifndef SERVER_HEAP_H
+#define SERVER_HEAP_H
+/////////////////////////////////////////////////////////////////////
+//  ServerHeap.h - an indexed binary heap of real servers
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the ServerHeap class, a binary min-heap of the indexes of
+* servers in a ServerTable. The order is given by a function comparing
+* two servers, e.g. by current load, and servers comparing equal are
+* ordered by index. The position of every server in the heap is kept
+* in an array indexed by server index, so a server whose load changes
+* is moved to its new place in O(log n), and any server can be taken
+* out in O(log n). The least server is read in O(1).
+*
+* Required Files:
+* ===============
+* ServerTable.h, ServerTable.cpp, ServerHeap.h, ServerHeap.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <vector>
+#include "ServerTable.h"
+
+
+//***********************************************************************
+// ServerHeap
+//
+// Servers are put into the heap, or moved after their keys change, by
+// update(), and taken out by erase(). The keys are read from the table
+// whenever they are compared, so update() must be invoked after the
+// key of a server in the heap changes.
+//***********************************************************************
+
+class ServerHeap
+{
+public:
+    // Return true if server a goes before server b.
+    using Less = bool (*)(const RealServer& a, const RealServer& b);
+
+    explicit ServerHeap(Less less);
+
+    void setServerTable(const ServerTable *server_table);
+    void clear();
+
+    void update(int index); // put a server in, or move it to its place
+    void erase(int index);  // take a server out, if it is in the heap
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    int top() const { return heap_.front(); } // index of the least server
+    bool contains(int index) const;
+private:
+    bool before(int a, int b) const; // compare servers at two indexes
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void place(size_t pos, int index);
+
+    std::vector<int> heap_;     // server indexes
+    std::vector<int> position_; // position in heap_ by server index, -1 if absent
+    const ServerTable *server_table_;
+    Less less_;
+};
+
+
+#endif
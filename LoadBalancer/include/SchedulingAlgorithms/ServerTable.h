@@ -0,0 +1,181 @@
+#ifndef SERVER_TABLE_H
+#define SERVER_TABLE_H
+/////////////////////////////////////////////////////////////////////
+//  ServerTable.h - real servers shared by a load balancer and its
+//                  scheduling algorithm
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Define the RealServer struct and the ServerTable class. A server
+* table keeps the real servers in a contiguous array. The index of a
+* server does not change while the server is in the table, and the
+* slot of a removed server is reused by the next server added, so a
+* scheduling algorithm can keep its own data in arrays indexed by the
+* same index.
+* The load balancer owns the table and updates loads in it. Scheduling
+* algorithms read the table directly instead of getting a copy of the
+* servers before each selection. A scheduling algorithm which keeps
+* an index of the servers, such as a heap ordered by load, registers
+* a Listener and is told about every server added or removed and every
+* change of load, so it only updates the entries which have changed.
+* The table also keeps the peak EWMA of the response time of every
+* server, measured by the load balancer.
+*
+* Required Files:
+* ===============
+* ServerTable.h, ServerTable.cpp
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* ver 1.1 : 16 Oct 2026
+* - peak EWMA of response time of every server
+* - setLatency() for an average computed elsewhere, e.g. shared by
+*   the workers, and peakEWMA() to compute it
+* - setMaxLoad() to change the weight of a server
+* - decayLatency() decays the peak EWMA of servers without samples, so
+*   a server slowed down once gets requests again
+*/
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+
+//***********************************************************************
+// RealServer
+//
+// A struct that represents a real server. The struct holds a real server's
+// IP address, port number, max load and current load. This struct is used
+// in a load balancer to schedule.
+// latency is the peak EWMA of the response time in microseconds, 0 before
+// the first response. latency_time is the time it is taken at, i.e. the
+// time of the last sample or of the last decay.
+//***********************************************************************
+
+struct RealServer
+{
+    std::string address;
+    std::string port_num;
+    int max_load;
+    int cur_load;
+    double latency;        // peak EWMA of response time, microseconds
+    uint64_t latency_time; // time latency is taken at, microseconds
+};
+
+
+//***********************************************************************
+// ServerTable
+//
+// An array of real servers with stable indexes. A server is also found
+// by the fd of its control connection, which the load balancer uses as
+// the key of a server.
+//***********************************************************************
+
+class ServerTable
+{
+public:
+    //*******************************************************************
+    // Listener
+    //
+    // Receives changes of a server table. Callbacks are invoked after
+    // the table has been changed.
+    //*******************************************************************
+    class Listener
+    {
+    public:
+        virtual ~Listener(){}
+        virtual void serverAdded(int){}
+        virtual void serverRemoved(int){}
+        virtual void loadChanged(int, int){} // index, load before change
+        virtual void latencyChanged(int){}
+    };
+
+    ServerTable();
+    ~ServerTable(){}
+    ServerTable(const ServerTable& ) = delete;
+    ServerTable& operator=(const ServerTable& ) = delete;
+
+    // Add a server and return its index. The server is put at index if
+    // it is given, otherwise into the first free slot.
+    // Return -1 if the slot is in use or fd is already in the table.
+    int add(int fd, const RealServer& server, int index = -1);
+    void remove(int index);
+
+    // Return the index of the server with this fd, or -1.
+    int find(int fd) const;
+
+    // Servers are at indexes from 0 to size() - 1. Some slots may be
+    // free, count() is the number of servers in the table.
+    int size() const { return static_cast<int>(slots_.size()); }
+    int count() const { return count_; }
+    bool inUse(int index) const { return slots_[index].in_use; }
+    int getFd(int index) const { return slots_[index].fd; }
+    const RealServer& get(int index) const { return slots_[index].server; }
+
+    // Change load of a server, listeners are told about it.
+    void setLoad(int index, int cur_load);
+    void increment(int index);
+    void decrement(int index);
+
+    // Change max load of a server. Listeners are not told, because an
+    // algorithm may derive its whole structure from the max loads, so
+    // it is rebuilt after max loads change.
+    void setMaxLoad(int index, int max_load);
+
+    // Add a sample of response time of a server, both in microseconds.
+    // A sample above the average replaces it at once (the peak), and a
+    // sample below is averaged in with a weight growing with the time
+    // since the last sample. now is any monotonic time.
+    void addLatency(int index, uint64_t rtt, uint64_t now);
+
+    // Set the average response time of a server and the time of its
+    // last sample.
+    void setLatency(int index, double latency, uint64_t latency_time);
+
+    // New peak EWMA after a sample rtt at now is added to latency,
+    // whose last sample was at latency_time (0 if none).
+    static double peakEWMA(double latency, uint64_t latency_time,
+                           uint64_t rtt, uint64_t now);
+
+    // Decay the peak EWMA of every server towards 0 by the time since
+    // its latency_time, as if a sample of 0 were taken at now. The
+    // owner of the table invokes it every LATENCY_DECAY_INTERVAL.
+    void decayLatency(uint64_t now);
+
+    // Interval between two decayLatency(), in microseconds
+    static const uint64_t LATENCY_DECAY_INTERVAL = 100000;
+
+    void addListener(Listener *listener);
+    void removeListener(Listener *listener);
+private:
+    // Time for the weight of the old average to fall to 1/e, in
+    // microseconds. A sample 500 times the others decays to them in
+    // about 12 seconds.
+    static const uint64_t LATENCY_DECAY = 2000000;
+
+    struct Slot
+    {
+        int fd;
+        bool in_use;
+        RealServer server;
+    };
+
+    std::vector<Slot> slots_;
+    std::unordered_map<int, int> fd_index_; // key is fd
+    int count_;
+    std::vector<Listener*> listeners_;
+};
+
+
+#endif
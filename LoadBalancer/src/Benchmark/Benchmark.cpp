@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////
+//  Benchmark.cpp - implementation of benchmark helpers
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <time.h>
+#include "../../include/Benchmark/Benchmark.h"
+
+const AlgorithmName ALGORITHM_NAMES[] = {
+    { "RR", Round_Robin },
+    { "WRR", Weighted_Round_Robin },
+    { "LC", Least_Connection },
+    { "WLC", Weighted_Least_Connection },
+    { "DH", Destination_Hashing },
+    { "SH", Source_Hashing },
+    { "P2C", Power_Of_Two_Choices },
+    { "MH", Maglev_Hashing },
+    { "PEWMA", Peak_EWMA },
+    { "SED", Shortest_Expected_Delay },
+    { "NQ", Never_Queue },
+    { "LBLC", Locality_Based_Least_Connection }
+};
+
+const int ALGORITHM_COUNT = sizeof(ALGORITHM_NAMES) / sizeof(ALGORITHM_NAMES[0]);
+
+//-------------------------------------------------------------------
+// Return the type of an algorithm by its name
+//-------------------------------------------------------------------
+bool findAlgorithm(const std::string& name, SchedAlgorithm& type)
+{
+    for (int i = 0; i < ALGORITHM_COUNT; i++)
+    {
+        if (name == ALGORITHM_NAMES[i].name)
+        {
+            type = ALGORITHM_NAMES[i].type;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-------------------------------------------------------------------
+// Monotonic time in nanoseconds
+//-------------------------------------------------------------------
+uint64_t getNanoTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+//-------------------------------------------------------------------
+// Add size made-up servers to an empty table
+//-------------------------------------------------------------------
+void fillServerTable(ServerTable& table, int size,
+                     const int *max_loads, int count)
+{
+    for (int i = 0; i < size; i++)
+    {
+        RealServer server;
+        server.address = "10." + std::to_string((i >> 16) & 0xff) + "." +
+                         std::to_string((i >> 8) & 0xff) + "." +
+                         std::to_string(i & 0xff);
+        server.port_num = "80";
+        server.max_load = max_loads[i % count];
+        server.cur_load = 0;
+        server.latency = 0.0;
+        server.latency_time = 0;
+        table.add(i + 1, server);
+    }
+}
@@ -0,0 +1,174 @@
+/////////////////////////////////////////////////////////////////////
+//  DispatchBenchmark.cpp - compare the cost of selecting a server by
+//                          AlgorithmSelector and by a direct call
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* For every scheduling algorithm, a table of made-up servers is
+* created, and the same number of servers are selected by an
+* AlgorithmSelector, which calls the algorithm by a virtual call as
+* the load balancer does, and by an object of the class of the
+* algorithm, which is final, so it is called directly. The direct call
+* is the most that could be saved by removing the virtual call. The two
+* are run by turns a few rounds, and the least time of each is printed
+* in nanoseconds per selection, in CSV format:
+*
+*     algorithm,servers,picks,virtual_ns,direct_ns
+*
+* Usage: dispatch_benchmark [-n servers] [-k picks] [algorithm ...]
+*
+* Required Files:
+* ===============
+* Benchmark.h, Benchmark.cpp, AlgorithmVisitor.h, SchedAlgorithms.h and
+* the files needed by SchedAlgorithms.h
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+* - the direct path calls the algorithm object, StaticSelector is
+*   removed
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include "../../include/Benchmark/Benchmark.h"
+#include "../../include/SchedulingAlgorithms/AlgorithmVisitor.h"
+
+static const int ROUNDS = 5;
+static const char *HANDLE_IP = "192.168.1.1";
+static const char *HANDLE_URL = "/index.html";
+
+// Sum of the selected fds, printed so the selections are not
+// optimized away
+static long long checksum = 0;
+
+//-------------------------------------------------------------------
+// Time picks selections of selector, in nanoseconds per selection
+//-------------------------------------------------------------------
+template <typename Selector>
+static double timePicks(Selector& selector, int picks)
+{
+    long long sum = 0;
+    uint64_t start = getNanoTime();
+    for (int i = 0; i < picks; i++)
+        sum += selector.selectServer();
+    uint64_t end = getNanoTime();
+
+    checksum += sum;
+    return static_cast<double>(end - start) / picks;
+}
+
+//-------------------------------------------------------------------
+// Run the benchmark for the algorithm type visitAlgorithm() finds
+//-------------------------------------------------------------------
+struct DispatchRunner
+{
+    SchedAlgorithm sched_type;
+    const char *name;
+    int servers;
+    int picks;
+
+    template <typename Algorithm>
+    void operator()(AlgorithmTag<Algorithm>)
+    {
+        static const int max_loads[] = { 10, 20, 40, 80 };
+        ServerTable table;
+        fillServerTable(table, servers, max_loads, 4);
+        for (int i = 0; i < servers; i++)
+            table.setLoad(i, rand() % (table.get(i).max_load / 2 + 1));
+
+        AlgorithmSelector dynamic_selector(sched_type);
+        dynamic_selector.selectAlgorithm();
+        dynamic_selector.setServerTable(&table);
+        dynamic_selector.setHandleIP(HANDLE_IP);
+        dynamic_selector.setHandleURL(HANDLE_URL);
+
+        Algorithm sched_algo;
+        sched_algo.setServerTable(&table);
+        sched_algo.setHandleIP(HANDLE_IP);
+        sched_algo.setHandleURL(HANDLE_URL);
+
+        double virtual_ns = 0.0, direct_ns = 0.0;
+        for (int round = 0; round < ROUNDS; round++)
+        {
+            double t = timePicks(dynamic_selector, picks);
+            if (round == 0 || t < virtual_ns)
+                virtual_ns = t;
+
+            t = timePicks(sched_algo, picks);
+            if (round == 0 || t < direct_ns)
+                direct_ns = t;
+        }
+
+        printf("%s,%d,%d,%.2f,%.2f\n", name, servers, picks, virtual_ns, direct_ns);
+    }
+};
+
+//-------------------------------------------------------------------
+// Run one algorithm by its name
+//-------------------------------------------------------------------
+static void runAlgorithm(const char *name, int servers, int picks)
+{
+    SchedAlgorithm sched_type;
+    if (!findAlgorithm(name, sched_type))
+    {
+        fprintf(stderr, "Incorrect scheduling algorithm: %s\n", name);
+        return;
+    }
+
+    DispatchRunner runner = { sched_type, name, servers, picks };
+    visitAlgorithm(sched_type, runner);
+}
+
+int main(int argc, char *argv[])
+{
+    int servers = 64;
+    int picks = 1000000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:k:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            servers = atoi(optarg);
+            break;
+        case 'k':
+            picks = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n servers] [-k picks] [algorithm ...]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (servers <= 0 || picks <= 0)
+    {
+        fprintf(stderr, "Number of servers and picks should be positive.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("algorithm,servers,picks,virtual_ns,direct_ns\n");
+    if (optind == argc)
+    {
+        for (int i = 0; i < ALGORITHM_COUNT; i++)
+            runAlgorithm(ALGORITHM_NAMES[i].name, servers, picks);
+    }
+    else
+    {
+        for (int i = optind; i < argc; i++)
+            runAlgorithm(argv[i], servers, picks);
+    }
+
+    fprintf(stderr, "checksum: %lld\n", checksum);
+    return 0;
+}
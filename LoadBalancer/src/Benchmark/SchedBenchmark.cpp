@@ -0,0 +1,474 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedBenchmark.cpp - measure the cost of scheduling algorithms
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* Measure the time a scheduling algorithm takes to select a server,
+* for every algorithm, with pools of 3 to 10000 real servers, whose
+* current loads are:
+* (1) uniform:   random from 0 to max load - 2
+* (2) skewed:    most servers lightly loaded, a few almost saturated
+* (3) saturated: one or two requests below the reserved capacity, and
+*                every tenth server without capacity
+* Every combination is run in three modes:
+* (1) select:    only selectServer(), loads do not change
+* (2) single:    what a worker does for a request. The client address
+*                and URL are handed to the algorithm, a server is
+*                selected, its load is increased, and the load of the
+*                request selected window picks before is decreased, so
+*                the algorithm also updates its structures.
+* (3) contended: the same as single, by several threads at a time,
+*                every one with its own server table and algorithm like
+*                a worker process, sharing a SharedLoadTable whose
+*                loads changed by the other threads are copied into
+*                the server table before every selection, as the load
+*                balancer does with workers.
+* A run lasts for a given time. The results are printed in CSV or JSON
+* format, one record per run:
+*
+*     algorithm,distribution,mode,servers,threads,picks,ns_per_pick,
+*     picks_per_sec,unavailable
+*
+* ns_per_pick is the time of one pick in one thread, picks_per_sec is
+* of all the threads together, unavailable is the number of picks no
+* server was available for.
+*
+* Usage: sched_benchmark [-f csv|json] [-n servers]... [-t threads]
+*                        [-d milliseconds] [algorithm ...]
+*
+* Required Files:
+* ===============
+* Benchmark.h, Benchmark.cpp, SharedLoadTable.h, SharedLoadTable.cpp,
+* SchedAlgorithms.h and the files needed by SchedAlgorithms.h
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <math.h>
+#include <errno.h>
+#include <pthread.h>
+#include "../../include/Benchmark/Benchmark.h"
+#include "../../include/LoadBalancer/SharedLoadTable.h"
+
+enum Distribution { Uniform, Skewed, Saturated };
+enum Mode { Select_Only, Single, Contended };
+
+static const char *DISTRIBUTION_NAMES[] = { "uniform", "skewed", "saturated" };
+static const char *MODE_NAMES[] = { "select", "single", "contended" };
+
+static const int MAX_LOADS[] = { 10, 20, 40, 80 };
+static const int MAX_LOAD_COUNT = 4;
+
+// Picks between two readings of the clock
+static const int BATCH = 256;
+
+// Different client addresses and URLs handed to the algorithms
+static const int CLIENT_COUNT = 1024;
+
+
+//***********************************************************************
+// Run
+//
+// Everything one run needs, shared by its threads.
+//***********************************************************************
+
+struct Run
+{
+    SchedAlgorithm sched_type;
+    Distribution distribution;
+    Mode mode;
+    int servers;
+    int threads;
+    uint64_t duration;              // nanoseconds
+    std::vector<int> base_loads;    // loads when the run starts
+    std::vector<std::string> ips;
+    std::vector<std::string> urls;
+    SharedLoadTable *load_table;    // only in contended mode
+    pthread_barrier_t barrier;
+};
+
+//***********************************************************************
+// Worker
+//
+// One thread of a run and its results.
+//***********************************************************************
+
+struct Worker
+{
+    Run *run;
+    int index;
+    pthread_t tid;
+    uint64_t picks;
+    uint64_t unavailable;
+    uint64_t elapsed;               // nanoseconds
+    long long checksum;             // sum of the selected fds, so the
+                                    // picks are not optimized away
+    std::vector<uint64_t> cursors;  // place in the logs of the shared
+    std::vector<int> changed;       // load table, as in a worker process
+};
+
+
+//-------------------------------------------------------------------
+// Loads of the servers when a run starts
+//-------------------------------------------------------------------
+static std::vector<int> makeLoads(Distribution distribution, int servers)
+{
+    unsigned int seed = 1;
+    std::vector<int> loads(servers);
+
+    for (int i = 0; i < servers; i++)
+    {
+        int max_load = MAX_LOADS[i % MAX_LOAD_COUNT];
+        double u = static_cast<double>(rand_r(&seed)) / (RAND_MAX + 1.0);
+
+        switch (distribution)
+        {
+        case Uniform:
+            loads[i] = static_cast<int>(u * (max_load - 1));
+            break;
+        case Skewed:
+            loads[i] = static_cast<int>(pow(u, 4) * (max_load - 1));
+            break;
+        case Saturated:
+            if (i % 10 == 9)
+                loads[i] = max_load - 1;
+            else
+                loads[i] = max_load - 2 - static_cast<int>(u * 2);
+            break;
+        }
+    }
+
+    return loads;
+}
+
+//-------------------------------------------------------------------
+// A request is sent to a server, or finished
+//-------------------------------------------------------------------
+static void addLoad(Worker *worker, ServerTable& table, int index)
+{
+    SharedLoadTable *load_table = worker->run->load_table;
+    if (load_table == nullptr)
+        table.increment(index);
+    else
+        table.setLoad(index, load_table->increment(worker->index, index));
+}
+
+static void subLoad(Worker *worker, ServerTable& table, int index)
+{
+    SharedLoadTable *load_table = worker->run->load_table;
+    if (load_table == nullptr)
+        table.decrement(index);
+    else
+        table.setLoad(index, load_table->decrement(worker->index, index));
+}
+
+//-------------------------------------------------------------------
+// Copy the shared loads changed by the other workers into the server
+// table of a worker, or all of them at the first call
+//-------------------------------------------------------------------
+static void syncLoads(Worker *worker, ServerTable& table)
+{
+    const SharedLoadTable *load_table = worker->run->load_table;
+    worker->changed.clear();
+    if (load_table->getChanges(worker->index, worker->cursors, worker->changed))
+    {
+        for (auto x : worker->changed)
+            table.setLoad(x, load_table->getLoad(x));
+        return;
+    }
+
+    for (int i = 0; i < table.size(); i++)
+    {
+        if (table.inUse(i))
+            table.setLoad(i, load_table->getLoad(i));
+    }
+}
+
+//-------------------------------------------------------------------
+// Thread function of a worker. Pick servers until the duration of the
+// run has passed.
+//-------------------------------------------------------------------
+static void* runWorker(void *arg)
+{
+    Worker *worker = static_cast<Worker*>(arg);
+    Run *run = worker->run;
+
+    ServerTable table;
+    fillServerTable(table, run->servers, MAX_LOADS, MAX_LOAD_COUNT);
+    if (run->load_table == nullptr)
+    {
+        for (int i = 0; i < run->servers; i++)
+            table.setLoad(i, run->base_loads[i]);
+    }
+    else
+        syncLoads(worker, table);
+
+    AlgorithmSelector selector(run->sched_type);
+    selector.selectAlgorithm();
+    selector.setServerTable(&table);
+
+    // Requests in flight, finished in the order they are sent
+    int window = run->servers / (2 * run->threads);
+    std::vector<int> in_flight((window > 0) ? window : 1, -1);
+    size_t next = 0;
+
+    unsigned int seed = worker->index + 1;
+
+    pthread_barrier_wait(&run->barrier);
+
+    uint64_t start = getNanoTime();
+    uint64_t now = start;
+    while (now - start < run->duration)
+    {
+        for (int i = 0; i < BATCH; i++)
+        {
+            int client = rand_r(&seed) % CLIENT_COUNT;
+            if (run->mode == Contended)
+                syncLoads(worker, table);
+            selector.setHandleIP(run->ips[client]);
+            selector.setHandleURL(run->urls[client]);
+
+            int fd = selector.selectServer();
+            worker->checksum += fd;
+            if (fd <= 0)
+                worker->unavailable++;
+            if (run->mode == Select_Only)
+                continue;
+
+            int index = (fd > 0) ? table.find(fd) : -1;
+            if (index != -1)
+                addLoad(worker, table, index);
+
+            if (in_flight[next] != -1)
+                subLoad(worker, table, in_flight[next]);
+            in_flight[next] = index;
+            next = (next + 1) % in_flight.size();
+        }
+
+        worker->picks += BATCH;
+        now = getNanoTime();
+    }
+    worker->elapsed = now - start;
+
+    // The requests still in flight are finished, so the shared loads
+    // are the same as before for the next run.
+    for (auto x : in_flight)
+    {
+        if (x != -1)
+            subLoad(worker, table, x);
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------------------
+// Print the result of a run
+//-------------------------------------------------------------------
+static void printResult(const Run& run, const char *name, bool json, bool first,
+                        uint64_t picks, double ns_per_pick, double picks_per_sec,
+                        uint64_t unavailable)
+{
+    if (json)
+    {
+        printf("%s\n  {\"algorithm\": \"%s\", \"distribution\": \"%s\", "
+               "\"mode\": \"%s\", \"servers\": %d, \"threads\": %d, "
+               "\"picks\": %llu, \"ns_per_pick\": %.2f, "
+               "\"picks_per_sec\": %.0f, \"unavailable\": %llu}",
+               first ? "" : ",", name, DISTRIBUTION_NAMES[run.distribution],
+               MODE_NAMES[run.mode], run.servers, run.threads,
+               static_cast<unsigned long long>(picks), ns_per_pick, picks_per_sec,
+               static_cast<unsigned long long>(unavailable));
+    }
+    else
+    {
+        printf("%s,%s,%s,%d,%d,%llu,%.2f,%.0f,%llu\n",
+               name, DISTRIBUTION_NAMES[run.distribution], MODE_NAMES[run.mode],
+               run.servers, run.threads, static_cast<unsigned long long>(picks),
+               ns_per_pick, picks_per_sec, static_cast<unsigned long long>(unavailable));
+    }
+    fflush(stdout);
+}
+
+//-------------------------------------------------------------------
+// Start the threads of a run, and wait for them to finish. If a thread
+// cannot be created, the threads already started would wait at the
+// barrier for ever, so the program exits.
+//-------------------------------------------------------------------
+static void startRun(Run& run, std::vector<Worker>& workers)
+{
+    pthread_barrier_init(&run.barrier, NULL, run.threads);
+
+    for (auto& x : workers)
+    {
+        int ret = pthread_create(&x.tid, NULL, runWorker, &x);
+        if (ret != 0)
+        {
+            errno = ret;
+            ErrorHandler eh("pthread_create", __FILE__, __FUNCTION__, __LINE__ - 4);
+            eh.errExit();
+        }
+    }
+
+    for (auto& x : workers)
+        pthread_join(x.tid, NULL);
+
+    pthread_barrier_destroy(&run.barrier);
+}
+
+int main(int argc, char *argv[])
+{
+    bool json = false;
+    int threads = 4;
+    int duration_ms = 50;
+    std::vector<int> sizes;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:n:t:d:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            json = (std::string(optarg) == "json");
+            break;
+        case 'n':
+            sizes.push_back(atoi(optarg));
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'd':
+            duration_ms = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-f csv|json] [-n servers]... [-t threads] "
+                            "[-d milliseconds] [algorithm ...]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (sizes.empty())
+        sizes = { 3, 10, 100, 1000, 10000 };
+
+    for (auto x : sizes)
+    {
+        if (x <= 0)
+        {
+            fprintf(stderr, "Number of servers should be positive.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (threads <= 0 || duration_ms <= 0)
+    {
+        fprintf(stderr, "Threads and duration should be positive.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<const AlgorithmName*> algorithms;
+    for (int i = 0; i < ALGORITHM_COUNT; i++)
+    {
+        bool listed = (optind == argc);
+        for (int j = optind; j < argc; j++)
+            listed = listed || (ALGORITHM_NAMES[i].name == std::string(argv[j]));
+        if (listed)
+            algorithms.push_back(&ALGORITHM_NAMES[i]);
+    }
+    for (int j = optind; j < argc; j++)
+    {
+        SchedAlgorithm type;
+        if (!findAlgorithm(argv[j], type))
+            fprintf(stderr, "Incorrect scheduling algorithm: %s\n", argv[j]);
+    }
+
+    if (json)
+        printf("[");
+    else
+        printf("algorithm,distribution,mode,servers,threads,picks,"
+               "ns_per_pick,picks_per_sec,unavailable\n");
+
+    long long checksum = 0;
+    bool first = true;
+    for (auto algorithm : algorithms)
+    {
+        for (auto servers : sizes)
+        {
+            for (int d = Uniform; d <= Saturated; d++)
+            {
+                for (int m = Select_Only; m <= Contended; m++)
+                {
+                    Run run;
+                    run.sched_type = algorithm->type;
+                    run.distribution = static_cast<Distribution>(d);
+                    run.mode = static_cast<Mode>(m);
+                    run.servers = servers;
+                    run.threads = (run.mode == Contended) ? threads : 1;
+                    run.duration = static_cast<uint64_t>(duration_ms) * 1000000;
+                    run.base_loads = makeLoads(run.distribution, servers);
+                    for (int i = 0; i < CLIENT_COUNT; i++)
+                    {
+                        run.ips.push_back("172.16." + std::to_string(i / 256) + "." +
+                                          std::to_string(i % 256));
+                        run.urls.push_back("/page" + std::to_string(i) + ".html");
+                    }
+
+                    SharedLoadTable load_table;
+                    run.load_table = nullptr;
+                    if (run.mode == Contended)
+                    {
+                        if (load_table.create(servers, run.threads) == -1)
+                            exit(EXIT_FAILURE);
+                        for (int i = 0; i < servers; i++)
+                        {
+                            for (int j = 0; j < run.base_loads[i]; j++)
+                                load_table.increment(0, i);
+                        }
+                        run.load_table = &load_table;
+                    }
+
+                    std::vector<Worker> workers(run.threads);
+                    for (int i = 0; i < run.threads; i++)
+                    {
+                        Worker worker = { &run, i, 0, 0, 0, 0, 0, {}, {} };
+                        workers[i] = worker;
+                    }
+                    startRun(run, workers);
+
+                    uint64_t picks = 0, unavailable = 0, elapsed = 0, wall = 0;
+                    for (auto& x : workers)
+                    {
+                        picks += x.picks;
+                        unavailable += x.unavailable;
+                        elapsed += x.elapsed;
+                        wall = (x.elapsed > wall) ? x.elapsed : wall;
+                        checksum += x.checksum;
+                    }
+
+                    printResult(run, algorithm->name, json, first, picks,
+                                static_cast<double>(elapsed) / picks,
+                                picks * 1e9 / wall, unavailable);
+                    first = false;
+
+                    if (run.mode == Contended)
+                        load_table.destroy();
+                }
+            }
+        }
+    }
+
+    if (json)
+        printf("\n]\n");
+
+    fprintf(stderr, "checksum: %lld\n", checksum);
+    return 0;
+}
@@ -0,0 +1,503 @@
+/////////////////////////////////////////////////////////////////////
+//  Simulator.cpp - replay a trace of requests against a model of a
+//                  pool of real servers
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+/*
+* File Description:
+* ==================
+* A discrete event simulator of the load balancer. Requests of a trace
+* arrive at their times, the real AlgorithmSelector selects a server
+* for each of them as the balancer does: the client address and the
+* URL are handed to the algorithm, the load of the server is increased
+* when a request is sent, and decreased with its response time
+* recorded when the response comes back. Response times are decayed
+* every LATENCY_DECAY_INTERVAL of the simulated clock, as the balancer
+* does. A request is rejected with 503 if no server is available.
+* A server has a number of workers, each of which serves its requests
+* in the order they come. A request takes service time / speed of the
+* server. The simulated clock jumps from one event to the next, so a
+* trace of hours runs in seconds.
+*
+* A trace is a text file, one request per line, times in microseconds:
+*
+*     arrival_time client_ip url service_time
+*
+* A pool file describes one server per line:
+*
+*     address port max_load speed [workers]
+*
+* Lines starting with '#' are ignored. Without a pool file, the pool
+* has 3 servers of max load 20 and speed 1 with 1 worker. Instead of a
+* trace, a Poisson trace can be generated by -g, with exponential
+* service times, and clients and URLs skewed towards a few popular
+* ones.
+*
+* Reported: 50th, 99th and 99.9th percentiles of the response times
+* of served requests, rate of 503, utilisation of every server, and
+* imbalance, which is the max utilisation / mean utilisation.
+*
+* Usage: simulator [-p pool_file] [-t trace_file | -g requests]
+*                  [-r rate] [-m mean_service] [-e epsilon]
+*                  [-x expire_time] [-f text|csv] algorithm
+*
+* Required Files:
+* ===============
+* Benchmark.h, Benchmark.cpp, SchedAlgorithms.h and the files needed by
+* SchedAlgorithms.h
+*
+* Maintenance History:
+* ====================
+* ver 1.0 : 16 Oct 2026
+* - first release
+*/
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <math.h>
+#include <fstream>
+#include <sstream>
+#include <queue>
+#include <algorithm>
+#include "../../include/Benchmark/Benchmark.h"
+
+
+//***********************************************************************
+// TraceRequest
+//
+// A request of the trace. Times are in microseconds.
+//***********************************************************************
+
+struct TraceRequest
+{
+    uint64_t arrival;
+    std::string client_ip;
+    std::string url;
+    uint64_t service;
+};
+
+//***********************************************************************
+// PoolServer
+//
+// Model of a real server and its statistics
+//***********************************************************************
+
+struct PoolServer
+{
+    RealServer server;
+    double speed;
+    std::vector<uint64_t> workers;  // time every worker becomes free
+    uint64_t requests;
+    uint64_t busy;                  // time its workers are busy in total
+    uint64_t latency_sum;
+};
+
+//***********************************************************************
+// Completion
+//
+// A response comes back to the load balancer.
+//***********************************************************************
+
+struct Completion
+{
+    uint64_t time;
+    uint64_t latency;
+    int index;
+
+    bool operator>(const Completion& other) const { return time > other.time; }
+};
+
+typedef std::priority_queue<Completion, std::vector<Completion>,
+                            std::greater<Completion>> CompletionQueue;
+
+
+//-------------------------------------------------------------------
+// Split a line into fields. Empty lines and comments have none.
+//-------------------------------------------------------------------
+static std::vector<std::string> splitLine(const std::string& line)
+{
+    std::vector<std::string> fields;
+    if (!line.empty() && line[0] == '#')
+        return fields;
+
+    std::istringstream in(line);
+    std::string field;
+    while (in >> field)
+        fields.push_back(field);
+    return fields;
+}
+
+//-------------------------------------------------------------------
+// Read the pool file
+//-------------------------------------------------------------------
+static bool readPool(const char *path, std::vector<PoolServer>& pool)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        fprintf(stderr, "Cannot open pool file %s.\n", path);
+        return false;
+    }
+
+    std::string line;
+    int line_num = 0;
+    while (std::getline(in, line))
+    {
+        line_num++;
+        std::vector<std::string> fields = splitLine(line);
+        if (fields.empty())
+            continue;
+
+        PoolServer server = { { fields[0], "", 0, 0, 0.0, 0 }, 0.0,
+                              std::vector<uint64_t>(), 0, 0, 0 };
+        int workers = 1;
+        if (fields.size() >= 4)
+        {
+            server.server.port_num = fields[1];
+            server.server.max_load = atoi(fields[2].c_str());
+            server.speed = atof(fields[3].c_str());
+            if (fields.size() >= 5)
+                workers = atoi(fields[4].c_str());
+        }
+
+        if (server.server.max_load <= 0 || server.speed <= 0.0 || workers <= 0)
+        {
+            fprintf(stderr, "Incorrect server at line %d of %s.\n", line_num, path);
+            return false;
+        }
+
+        server.workers.assign(workers, 0);
+        pool.push_back(server);
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Read the trace file
+//-------------------------------------------------------------------
+static bool readTrace(const char *path, std::vector<TraceRequest>& trace)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        fprintf(stderr, "Cannot open trace file %s.\n", path);
+        return false;
+    }
+
+    std::string line;
+    int line_num = 0;
+    while (std::getline(in, line))
+    {
+        line_num++;
+        std::vector<std::string> fields = splitLine(line);
+        if (fields.empty())
+            continue;
+
+        if (fields.size() < 4)
+        {
+            fprintf(stderr, "Incorrect request at line %d of %s.\n", line_num, path);
+            return false;
+        }
+
+        TraceRequest request = { strtoull(fields[0].c_str(), NULL, 10), fields[1],
+                                 fields[2], strtoull(fields[3].c_str(), NULL, 10) };
+        trace.push_back(request);
+    }
+
+    // The trace may not be sorted by arrival time.
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](const TraceRequest& a, const TraceRequest& b)
+                     { return a.arrival < b.arrival; });
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Generate a Poisson trace. rate is in requests per second, service
+// times are in microseconds. The i-th of n clients is chosen with a
+// probability falling with i, so a few clients send most requests.
+//-------------------------------------------------------------------
+static void generateTrace(int count, double rate, double mean_service,
+                          std::vector<TraceRequest>& trace)
+{
+    static const int CLIENT_COUNT = 1000;
+    static const int URL_COUNT = 1000;
+
+    unsigned int seed = 1;
+    auto uniform = [&seed]() {
+        return (rand_r(&seed) + 1.0) / (RAND_MAX + 2.0);
+    };
+
+    double now = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        now += -log(uniform()) / rate * 1e6;
+
+        int client = static_cast<int>(pow(uniform(), 3) * CLIENT_COUNT);
+        int url = static_cast<int>(pow(uniform(), 3) * URL_COUNT);
+        TraceRequest request = {
+            static_cast<uint64_t>(now),
+            "172.16." + std::to_string(client / 256) + "." + std::to_string(client % 256),
+            "/page" + std::to_string(url) + ".html",
+            static_cast<uint64_t>(-log(uniform()) * mean_service) + 1
+        };
+        trace.push_back(request);
+    }
+}
+
+//-------------------------------------------------------------------
+// Responses which come back by time now
+//-------------------------------------------------------------------
+static void finishUntil(uint64_t now, CompletionQueue& completions,
+                        ServerTable& table)
+{
+    while (!completions.empty() && completions.top().time <= now)
+    {
+        const Completion& x = completions.top();
+        table.decrement(x.index);
+        table.addLatency(x.index, x.latency, x.time);
+        completions.pop();
+    }
+}
+
+//-------------------------------------------------------------------
+// Percentile of sorted values
+//-------------------------------------------------------------------
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    size_t rank = static_cast<size_t>(ceil(p * sorted.size()));
+    return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pool_file = nullptr;
+    const char *trace_file = nullptr;
+    int generate = 0;
+    double rate = 1000.0;
+    double mean_service = 2000.0;
+    double epsilon = -1.0;
+    int expire_time = 0;
+    bool csv = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:t:g:r:m:e:x:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            pool_file = optarg;
+            break;
+        case 't':
+            trace_file = optarg;
+            break;
+        case 'g':
+            generate = atoi(optarg);
+            break;
+        case 'r':
+            rate = atof(optarg);
+            break;
+        case 'm':
+            mean_service = atof(optarg);
+            break;
+        case 'e':
+            epsilon = atof(optarg);
+            break;
+        case 'x':
+            expire_time = atoi(optarg);
+            break;
+        case 'f':
+            csv = (std::string(optarg) == "csv");
+            break;
+        default:
+            optind = argc;
+            break;
+        }
+    }
+
+    SchedAlgorithm sched_type;
+    if (optind != argc - 1 || (trace_file == nullptr) == (generate <= 0))
+    {
+        fprintf(stderr, "Usage: %s [-p pool_file] [-t trace_file | -g requests] "
+                        "[-r rate] [-m mean_service] [-e epsilon] [-x expire_time] "
+                        "[-f text|csv] algorithm\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (!findAlgorithm(argv[optind], sched_type))
+    {
+        fprintf(stderr, "Incorrect scheduling algorithm.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (rate <= 0.0 || mean_service <= 0.0)
+    {
+        fprintf(stderr, "Rate and service time should be positive.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<PoolServer> pool;
+    if (pool_file == nullptr)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            PoolServer server = { { "10.0.0." + std::to_string(i + 1), "80", 20, 0, 0.0, 0 },
+                                  1.0, std::vector<uint64_t>(1, 0), 0, 0, 0 };
+            pool.push_back(server);
+        }
+    }
+    else if (!readPool(pool_file, pool))
+        exit(EXIT_FAILURE);
+
+    if (pool.empty())
+    {
+        fprintf(stderr, "No real server is in the pool.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<TraceRequest> trace;
+    if (trace_file != nullptr)
+    {
+        if (!readTrace(trace_file, trace))
+            exit(EXIT_FAILURE);
+    }
+    else
+        generateTrace(generate, rate, mean_service, trace);
+
+    if (trace.empty())
+    {
+        fprintf(stderr, "No request is in the trace.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // The fd of a server is its index + 1.
+    ServerTable table;
+    for (size_t i = 0; i < pool.size(); i++)
+    {
+        if (table.add(i + 1, pool[i].server, i) == -1)
+        {
+            fprintf(stderr, "Server %s:%s is in the pool twice.\n",
+                    pool[i].server.address.c_str(), pool[i].server.port_num.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    AlgorithmSelector selector(sched_type);
+    selector.selectAlgorithm();
+    selector.setServerTable(&table);
+    selector.setLoadBound(epsilon);
+    selector.setExpireTime(expire_time);
+
+    uint64_t wall_start = getNanoTime();
+
+    CompletionQueue completions;
+    std::vector<uint64_t> latencies;
+    latencies.reserve(trace.size());
+    uint64_t rejected = 0;
+    uint64_t end_time = trace.front().arrival;
+    uint64_t decay_time = trace.front().arrival;
+
+    for (const auto& x : trace)
+    {
+        finishUntil(x.arrival, completions, table);
+        if (x.arrival - decay_time >= ServerTable::LATENCY_DECAY_INTERVAL)
+        {
+            table.decayLatency(x.arrival);
+            decay_time = x.arrival;
+        }
+
+        selector.setHandleIP(x.client_ip);
+        selector.setHandleURL(x.url);
+        int fd = selector.selectServer();
+        int index = (fd > 0) ? table.find(fd) : -1;
+        if (index == -1)
+        {
+            rejected++;
+            continue;
+        }
+
+        table.increment(index);
+
+        // The request waits for the worker of the server which becomes
+        // free first.
+        PoolServer& server = pool[index];
+        auto worker = std::min_element(server.workers.begin(), server.workers.end());
+        uint64_t start = (*worker > x.arrival) ? *worker : x.arrival;
+        uint64_t service = static_cast<uint64_t>(ceil(x.service / server.speed));
+        *worker = start + service;
+
+        uint64_t latency = *worker - x.arrival;
+        Completion completion = { *worker, latency, index };
+        completions.push(completion);
+        latencies.push_back(latency);
+
+        server.requests++;
+        server.busy += service;
+        server.latency_sum += latency;
+        end_time = (*worker > end_time) ? *worker : end_time;
+    }
+    finishUntil(end_time, completions, table);
+
+    double wall_time = (getNanoTime() - wall_start) / 1e9;
+    double sim_time = (end_time - trace.front().arrival) / 1e6;
+    std::sort(latencies.begin(), latencies.end());
+
+    // Utilisation of a server is the part of the simulated time its
+    // workers are busy.
+    std::vector<double> utilisation(pool.size());
+    double util_sum = 0.0, util_max = 0.0;
+    for (size_t i = 0; i < pool.size(); i++)
+    {
+        double capacity = sim_time * 1e6 * pool[i].workers.size();
+        utilisation[i] = (capacity > 0.0) ? pool[i].busy / capacity : 0.0;
+        util_sum += utilisation[i];
+        util_max = (utilisation[i] > util_max) ? utilisation[i] : util_max;
+    }
+    double imbalance = (util_sum > 0.0) ? util_max / (util_sum / pool.size()) : 1.0;
+    double reject_rate = static_cast<double>(rejected) / trace.size();
+
+    if (csv)
+    {
+        printf("algorithm,requests,rejected_rate,p50_us,p99_us,p999_us,"
+               "imbalance,simulated_s,wall_s\n");
+        printf("%s,%zu,%.6f,%llu,%llu,%llu,%.4f,%.3f,%.3f\n", argv[optind],
+               trace.size(), reject_rate,
+               static_cast<unsigned long long>(percentile(latencies, 0.50)),
+               static_cast<unsigned long long>(percentile(latencies, 0.99)),
+               static_cast<unsigned long long>(percentile(latencies, 0.999)),
+               imbalance, sim_time, wall_time);
+        return 0;
+    }
+
+    printf("Algorithm:      %s\n", argv[optind]);
+    printf("Requests:       %zu\n", trace.size());
+    printf("Rejected (503): %llu (%.3f%%)\n",
+           static_cast<unsigned long long>(rejected), reject_rate * 100);
+    printf("Latency (us):   p50 %llu, p99 %llu, p999 %llu\n",
+           static_cast<unsigned long long>(percentile(latencies, 0.50)),
+           static_cast<unsigned long long>(percentile(latencies, 0.99)),
+           static_cast<unsigned long long>(percentile(latencies, 0.999)));
+    printf("Simulated time: %.3f s in %.3f s\n", sim_time, wall_time);
+    printf("Imbalance:      %.4f (max / mean utilisation)\n\n", imbalance);
+
+    printf("%-22s%10s%10s%10s%14s%18s\n", "Server", "Max Load", "Speed",
+           "Requests", "Utilisation", "Mean Latency (us)");
+    for (size_t i = 0; i < pool.size(); i++)
+    {
+        const PoolServer& x = pool[i];
+        std::string name = x.server.address + ":" + x.server.port_num;
+        printf("%-22s%10d%10.2f%10llu%13.1f%%%18.0f\n", name.c_str(),
+               x.server.max_load, x.speed, static_cast<unsigned long long>(x.requests),
+               utilisation[i] * 100,
+               (x.requests > 0) ? static_cast<double>(x.latency_sum) / x.requests : 0.0);
+    }
+
+    return 0;
+}
@@ -260,21 +260,18 @@ void* ClientManager::createClient(void *arg)
     {
         cm->request_map_.at(option)(cm);
 
-        if (write(cfd, cm->send_msg_.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
+        if (ConnBuffer::writeFull(cfd, cm->send_msg_.http_msg.data(), 
+                                  cm->send_msg_.http_msg.size()) == -1)
         {
             ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
             eh.errExit();
         }
         pthread_mutex_unlock(&mtx_);
 
+        // A response may arrive in several reads.
         HTTPMessage recv_msg;
-        ssize_t num_read = read(cfd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-        if (num_read == -1)
-        {
-            ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
-            eh.errMsg();
-        }
-        if (num_read == 0)
+        ConnBuffer buffer;
+        if (!buffer.waitMessage(cfd, recv_msg))
             fprintf(stderr, "unexpected EOF from server\n");
 
         DebugCode(std::cout << "Client receive:\n";
@@ -0,0 +1,376 @@
+/////////////////////////////////////////////////////////////////////
+//  ConnBuffer.cpp - implementation of ConnBuffer class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/Common/ConnBuffer.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+ConnBuffer::ConnBuffer()
+    : input_begin_(0), input_end_(0), output_begin_(0),
+      read_state_(READ_OPEN), events_(0)
+{}
+
+//-------------------------------------------------------------------
+// Read the socket until no more bytes are available. A read which
+// returns less than asked means that the socket has been drained, so
+// the loop stops without waiting for EAGAIN.
+//-------------------------------------------------------------------
+ConnBuffer::ReadState ConnBuffer::readFrom(int fd)
+{
+    while (read_state_ == READ_OPEN)
+    {
+        ssize_t num_read = receive(fd, MSG_DONTWAIT);
+        if (num_read > 0 && static_cast<size_t>(num_read) < READ_SIZE)
+            break;
+        if (num_read == -1)
+            break;
+    }
+
+    return read_state_;
+}
+
+//-------------------------------------------------------------------
+// Read a blocking socket until a complete message is taken out. The
+// bytes read behind the message are kept for the next call.
+// return: true -- a message is copied into msg
+//         false -- the connection is closed or broken
+//-------------------------------------------------------------------
+bool ConnBuffer::waitMessage(int fd, HTTPMessage& msg)
+{
+    while (!getMessage(msg))
+    {
+        if (read_state_ != READ_OPEN)
+            return false;
+        receive(fd, 0);
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Append bytes which have been read by the owner, such as by an 
+// io_uring read into a registered buffer.
+//-------------------------------------------------------------------
+void ConnBuffer::append(const char *data, size_t n)
+{
+    reserveInput(n);
+    memcpy(&input_[input_end_], data, n);
+    input_end_ += n;
+}
+
+//-------------------------------------------------------------------
+// Return whether the peer has closed the connection.
+//-------------------------------------------------------------------
+ConnBuffer::ReadState ConnBuffer::getReadState() const
+{
+    return read_state_;
+}
+
+//-------------------------------------------------------------------
+// A message is framed as in HTTP/1.1: start line and header end with
+// an empty line, and the body has Content-Length bytes, none if there
+// is no Content-Length. Empty lines before a message are skipped.
+// A header that is too long, or a bad Content-Length, breaks the 
+// framing of the connection, so the read state becomes READ_ERROR.
+// return: true -- a message is copied into msg
+//         false -- the message has not been read completely
+//-------------------------------------------------------------------
+bool ConnBuffer::getMessage(HTTPMessage& msg)
+{
+    while (input_end_ - input_begin_ >= 2 && 
+           input_[input_begin_] == '\r' && input_[input_begin_ + 1] == '\n')
+        input_begin_ += 2;
+
+    size_t size = input_end_ - input_begin_;
+    if (size == 0)
+    {
+        input_begin_ = input_end_ = 0;
+        return false;
+    }
+
+    const char *begin = &input_[input_begin_];
+    const char *header_end = static_cast<const char*>(memmem(begin, size, "\r\n\r\n", 4));
+    if (header_end == NULL)
+    {
+        if (size > HTTPMessage::MAX_HEADER_SIZE)
+        {
+            fprintf(stderr, "header of a message is too long\n");
+            read_state_ = READ_ERROR;
+        }
+        return false;
+    }
+
+    size_t header_len = header_end + 4 - begin;
+    size_t body_len = 0;
+    if (getContentLength(begin, header_len, body_len) == -1 ||
+        body_len > HTTPMessage::MAX_MSG_SIZE - header_len)
+    {
+        fprintf(stderr, "bad Content-Length of a message\n");
+        read_state_ = READ_ERROR;
+        return false;
+    }
+
+    if (size < header_len + body_len)
+        return false;
+
+    msg.http_msg.assign(begin, header_len + body_len);
+    input_begin_ += header_len + body_len;
+    if (input_begin_ == input_end_)
+        input_begin_ = input_end_ = 0;
+
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Append a message to the output queue. Only the bytes of the message
+// are queued. It is not sent until flushTo() is invoked.
+//-------------------------------------------------------------------
+void ConnBuffer::queueMessage(const HTTPMessage& msg)
+{
+    output_.insert(output_.end(), msg.http_msg.begin(), msg.http_msg.end());
+}
+
+//-------------------------------------------------------------------
+// Return whether there are bytes waiting to be sent.
+//-------------------------------------------------------------------
+bool ConnBuffer::hasOutput() const
+{
+    return output_begin_ < output_.size();
+}
+
+//-------------------------------------------------------------------
+// Send the output queue until it is empty or the socket is full.
+// MSG_NOSIGNAL avoids SIGPIPE when the peer has closed the connection,
+// and the error is returned instead.
+//-------------------------------------------------------------------
+int ConnBuffer::flushTo(int fd)
+{
+    while (output_begin_ < output_.size())
+    {
+        ssize_t num_written = send(fd, &output_[output_begin_], output_.size() - output_begin_,
+                                   MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (num_written >= 0)
+            output_begin_ += num_written;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 1;
+        else if (errno != EINTR)
+        {
+            ErrorHandler eh("send", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+            return -1;
+        }
+    }
+
+    output_.clear();
+    output_begin_ = 0;
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Get the events registered for the socket
+//-------------------------------------------------------------------
+uint32_t ConnBuffer::getEvents() const
+{
+    return events_;
+}
+
+//-------------------------------------------------------------------
+// Set the events registered for the socket
+//-------------------------------------------------------------------
+void ConnBuffer::setEvents(uint32_t events)
+{
+    events_ = events;
+}
+
+//-------------------------------------------------------------------
+// Make room for n more bytes behind the input. The unread bytes are
+// moved to the front before the buffer grows.
+//-------------------------------------------------------------------
+void ConnBuffer::reserveInput(size_t n)
+{
+    if (input_begin_ > 0)
+    {
+        std::copy(input_.begin() + input_begin_, input_.begin() + input_end_,
+                  input_.begin());
+        input_end_ -= input_begin_;
+        input_begin_ = 0;
+    }
+    if (input_.size() < input_end_ + n)
+        input_.resize(input_end_ + n);
+}
+
+//-------------------------------------------------------------------
+// Receive once into the input buffer, and update the read state.
+// return: -1 -- no byte is read, because of EAGAIN, end of file or
+//               an error
+//         otherwise -- number of bytes read
+//-------------------------------------------------------------------
+ssize_t ConnBuffer::receive(int fd, int flags)
+{
+    reserveInput(READ_SIZE);
+
+    ssize_t num_read = recv(fd, &input_[input_end_], READ_SIZE, flags);
+    if (num_read > 0)
+    {
+        input_end_ += num_read;
+        return num_read;
+    }
+
+    if (num_read == 0)
+        read_state_ = READ_EOF;
+    else if (errno == EINTR)
+        return 0;
+    else if (errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        ErrorHandler eh("recv", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        read_state_ = READ_ERROR;
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------------------
+// Get the value of Content-Length in a header, 0 if there is none.
+// Header names are case-insensitive.
+// return: -1 -- the value is not a number
+//          0 -- success
+//-------------------------------------------------------------------
+int ConnBuffer::getContentLength(const char *header, size_t len, size_t& length)
+{
+    static const char name[] = "\r\ncontent-length:";
+    const size_t name_len = sizeof(name) - 1;
+
+    length = 0;
+    for (size_t i = 0; i + name_len <= len; i++)
+    {
+        if (header[i] != '\r' || strncasecmp(header + i, name, name_len) != 0)
+            continue;
+
+        size_t pos = i + name_len;
+        while (pos < len && header[pos] == ' ')
+            pos++;
+        if (pos >= len || !isdigit(header[pos]))
+            return -1;
+
+        while (pos < len && isdigit(header[pos]))
+        {
+            if (length > HTTPMessage::MAX_MSG_SIZE)
+                return -1;
+            length = length * 10 + (header[pos] - '0');
+            pos++;
+        }
+        return 0;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Write a message to a blocking stream pipe, behind its length. A 
+// pipe carries no HTTP framing of its own, so the length tells the
+// reader how many bytes to take.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int ConnBuffer::writeMessage(int fd, const HTTPMessage& msg)
+{
+    uint32_t len = msg.http_msg.size();
+    if (writeFull(fd, &len, sizeof(len)) == -1 ||
+        writeFull(fd, msg.http_msg.data(), len) == -1)
+        return -1;
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Read a message written by writeMessage() from a blocking fd.
+// return: -1 -- occur an error
+//          0 -- end of file, even in the middle of a message
+//          1 -- a message is read
+//-------------------------------------------------------------------
+int ConnBuffer::readMessage(int fd, HTTPMessage& msg)
+{
+    uint32_t len;
+    ssize_t num_read = readFull(fd, &len, sizeof(len));
+    if (num_read < static_cast<ssize_t>(sizeof(len)))
+        return (num_read == -1) ? -1 : 0;
+    if (len > HTTPMessage::MAX_MSG_SIZE)
+    {
+        fprintf(stderr, "message on the pipe is too long\n");
+        return -1;
+    }
+
+    msg.http_msg.resize(len);
+    if (len > 0)
+    {
+        num_read = readFull(fd, &msg.http_msg[0], len);
+        if (num_read < static_cast<ssize_t>(len))
+            return (num_read == -1) ? -1 : 0;
+    }
+
+    return 1;
+}
+
+//-------------------------------------------------------------------
+// Read n bytes from a blocking fd.
+// return: -1 -- occur an error
+//          0 -- end of file before any byte is read
+//         otherwise -- number of bytes read, less than n only if end
+//                      of file is met
+//-------------------------------------------------------------------
+ssize_t ConnBuffer::readFull(int fd, void *buf, size_t n)
+{
+    size_t total = 0;
+    char *p = static_cast<char*>(buf);
+
+    while (total < n)
+    {
+        ssize_t num_read = read(fd, p + total, n - total);
+        if (num_read == 0)
+            break;
+        if (num_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        total += num_read;
+    }
+
+    return total;
+}
+
+//-------------------------------------------------------------------
+// Write n bytes to a blocking fd.
+// return: -1 -- occur an error
+//         n -- success
+//-------------------------------------------------------------------
+ssize_t ConnBuffer::writeFull(int fd, const void *buf, size_t n)
+{
+    size_t total = 0;
+    const char *p = static_cast<const char*>(buf);
+
+    while (total < n)
+    {
+        ssize_t num_written = write(fd, p + total, n - total);
+        if (num_written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        total += num_written;
+    }
+
+    return total;
+}
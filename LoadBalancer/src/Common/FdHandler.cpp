@@ -122,6 +122,41 @@ void addEvent(int epollfd, int fd, OneShotType oneshot_type, BlockType block_typ
         setNonBlocking(fd);
 }
 
+//-------------------------------------------------------------------
+// Add an fd to an epoll fd monitoring list with given events, 
+// such as EPOLLIN | EPOLLOUT | EPOLLET
+//-------------------------------------------------------------------
+void addEventMask(int epollfd, int fd, uint32_t events, BlockType block_type)
+{
+    struct epoll_event ev;
+    ev.data.fd = fd;
+    ev.events = events;
+
+    // Set O_NONBLOCK before adding, because an edge triggered fd may 
+    // be read as soon as it is added.
+    if (block_type == NON_BLOCK)
+        setNonBlocking(fd);
+
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+    {
+        perror("epoll_ctl - EPOLL_CTL_ADD");
+        exit(EXIT_FAILURE);
+    }
+}
+
+//-------------------------------------------------------------------
+// Change the events of an fd in an epoll fd monitoring list
+//-------------------------------------------------------------------
+void modifyEvent(int epollfd, int fd, uint32_t events)
+{
+    struct epoll_event ev;
+    ev.data.fd = fd;
+    ev.events = events;
+
+    if (epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev) == -1)
+        perror("epoll_ctl - EPOLL_CTL_MOD");
+}
+
 //-------------------------------------------------------------------
 // Delete an fd from an epoll fd monitoring list
 //-------------------------------------------------------------------
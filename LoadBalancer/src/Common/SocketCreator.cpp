@@ -68,7 +68,8 @@ int SocketCreator::inetPassiveSocket(const char *host,
                                      int type, 
                                      socklen_t *addrlen,
                                      bool do_listen, 
-                                     int backlog)
+                                     int backlog,
+                                     bool reuse_port)
 {
     struct addrinfo hints;
     struct addrinfo *result, *rp;
@@ -111,6 +112,21 @@ int SocketCreator::inetPassiveSocket(const char *host,
             }
         }
 
+        // SO_REUSEPORT lets several sockets bind to the same address,
+        // and the kernel spreads incoming connections among them.
+        if (reuse_port)
+        {
+            if (setsockopt(sfd, SOL_SOCKET, SO_REUSEPORT, &optval,
+                    sizeof(optval)) == -1) 
+            {
+                ErrorHandler eh("setsockopt", __FILE__, __FUNCTION__, __LINE__);
+                eh.errMsg();
+                close(sfd);
+                freeaddrinfo(result);
+                return -1;
+            }
+        }
+
         if (bind(sfd, rp->ai_addr, rp->ai_addrlen) == 0)
             break;                     
 
@@ -153,6 +169,24 @@ int SocketCreator::inetListen(const char *host,
                              backlog);     // backlog
 }
 
+//-------------------------------------------------------------------
+// Listen to a socket with SO_REUSEPORT, so that every worker of a 
+// server can own a listen socket on the same IP address and port.
+//-------------------------------------------------------------------
+int SocketCreator::inetReusePortListen(const char *host, 
+                                       const char *service, 
+                                       int backlog, 
+                                       socklen_t *addrlen)
+{
+    return inetPassiveSocket(host,         // host
+                             service,      // service
+                             SOCK_STREAM,  // type
+                             addrlen,      // addrlen
+                             true,         // do_listen
+                             backlog,      // backlog
+                             true);        // reuse_port
+}
+
 //-------------------------------------------------------------------
 // Bind to an IP address and port number, used in a server.
 //-------------------------------------------------------------------
@@ -164,16 +164,9 @@ void HTTPReader::start()
     if (header_.size() <= 0)
         return;
 
-    // get body of an HTTP message
-    for (StringPos i = index; i <= request_msg_.size() - 2; i++)
-    {
-        // body ends with "\r\n"
-        if (request_msg_.at(i) == '\r' && request_msg_.at(i + 1) == '\n')
-        {
-            body_ = request_msg_.substr(index, i - index);
-            break;
-        }
-    }
+    // get body of an HTTP message, which is the rest of the message,
+    // since a message is taken from the wire by its Content-Length
+    body_ = request_msg_.substr(index);
     
     parseHTTPMsg();
 }
@@ -316,6 +309,14 @@ void HTTPReader::parseHTTPMsg()
                 response_msg_ = response_handler.errorResponse(error_code);
                 break;
             }
+
+            // Send the request ID given by the load balancer back, so
+            // that the load balancer can find the request.
+            if (response_handler.getRequestID().size() > 0)
+            {
+                std::string request_id = "Request-ID: " + response_handler.getRequestID();
+                HTTPWriter::insertHeader(response_msg_, request_id.c_str());
+            }
             finish = true;
             break;
         }
@@ -29,64 +29,79 @@ ResponseHandler::ResponseHandler(const std::string& url,
 //-------------------------------------------------------------------
 void ResponseHandler::initHeaderHandlerTable()
 {
-    // GET method handler can handle "Accept", "Host", "Source-IP" and "Source-Port".
+    // GET method handler can handle "Accept", "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     get_handler_table_.insert({ "Accept", handleAccept });
     get_handler_table_.insert({ "Host", handleHost });
     get_handler_table_.insert({ "Source-IP", handleSourceIP });
     get_handler_table_.insert({ "Source-Port", handleSourcePort });
+    get_handler_table_.insert({ "Request-ID", handleRequestID });
 
-    // HEAD method handler can handle "Accept", "Host", "Source-IP" and "Source-Port".
+    // HEAD method handler can handle "Accept", "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     head_handler_table_.insert({ "Accept", handleAccept });
     head_handler_table_.insert({ "Host", handleHost });
     head_handler_table_.insert({ "Source-IP", handleSourceIP });
     head_handler_table_.insert({ "Source-Port", handleSourcePort });
+    head_handler_table_.insert({ "Request-ID", handleRequestID });
 
     // PUT method handler can handle "Host", "Content-Type", "Content-Length", 
-    // "Source-IP" and "Source-Port".
+    // "Source-IP", "Source-Port" and "Request-ID".
     put_handler_table_.insert({ "Host", handleHost });
     put_handler_table_.insert({ "Content-Type", handleContentType });
     put_handler_table_.insert({ "Content-Length", handleContentLength });
     put_handler_table_.insert({ "Source-IP", handleSourceIP });
     put_handler_table_.insert({ "Source-Port", handleSourcePort });
+    put_handler_table_.insert({ "Request-ID", handleRequestID });
 
     // POST method handler can handle "Host", "Content-Type", "Content-Length", 
-    // "Source-IP" and "Source-Port".
+    // "Source-IP", "Source-Port" and "Request-ID".
     post_handler_table_.insert({ "Host", handleHost });
     post_handler_table_.insert({ "Content-Type", handleContentType });
     post_handler_table_.insert({ "Content-Length", handleContentLength });
     post_handler_table_.insert({ "Source-IP", handleSourceIP });
     post_handler_table_.insert({ "Source-Port", handleSourcePort });
+    post_handler_table_.insert({ "Request-ID", handleRequestID });
 
-    // TRACE method handler can handle "Accept", "Host", "Source-IP" and "Source-Port".
+    // TRACE method handler can handle "Accept", "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     trace_handler_table_.insert({ "Accept", handleAccept });
     trace_handler_table_.insert({ "Host", handleHost });
     trace_handler_table_.insert({ "Source-IP", handleSourceIP });
     trace_handler_table_.insert({ "Source-Port", handleSourcePort });
+    trace_handler_table_.insert({ "Request-ID", handleRequestID });
 
-    // OPTIONS method handler can handle "Accept", "Host", "Source-IP" and "Source-Port".
+    // OPTIONS method handler can handle "Accept", "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     options_handler_table_.insert({ "Accept", handleAccept });
     options_handler_table_.insert({ "Host", handleHost });
     options_handler_table_.insert({ "Source-IP", handleSourceIP });
     options_handler_table_.insert({ "Source-Port", handleSourcePort });
+    options_handler_table_.insert({ "Request-ID", handleRequestID });
 
-    // DELETE method handler can handle "Host", "Source-IP" and "Source-Port".
+    // DELETE method handler can handle "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     delete_handler_table_.insert({ "Host", handleHost });
     delete_handler_table_.insert({ "Source-IP", handleSourceIP });
     delete_handler_table_.insert({ "Source-Port", handleSourcePort });
+    delete_handler_table_.insert({ "Request-ID", handleRequestID });
 
-    // SERVERCHECK method handler can handle "Host", "Source-IP" and "Source-Port".
+    // SERVERCHECK method handler can handle "Host", "Source-IP", 
+    // "Source-Port" and "Request-ID".
     server_check_handler_table_.insert({ "Host", handleHost });
     server_check_handler_table_.insert({ "Source-IP", handleSourceIP });
     server_check_handler_table_.insert({ "Source-Port", handleSourcePort });
+    server_check_handler_table_.insert({ "Request-ID", handleRequestID });
 
     // Error handler can handle "Accept", "Host", "Content-Type", 
-    // "Content-Length", "Source-IP" and "Source-Port".
+    // "Content-Length", "Source-IP", "Source-Port" and "Request-ID".
     error_handler_table_.insert({ "Accept", handleAccept });
     error_handler_table_.insert({ "Host", handleHost });
     error_handler_table_.insert({ "Content-Type", handleContentType });
     error_handler_table_.insert({ "Content-Length", handleContentLength });
     error_handler_table_.insert({ "Source-IP", handleSourceIP });
     error_handler_table_.insert({ "Source-Port", handleSourcePort });
+    error_handler_table_.insert({ "Request-ID", handleRequestID });
 
     // header handler table stores different methods as keys, and 
     // corresponding handler table as values.
@@ -136,6 +151,25 @@ void ResponseHandler::handleSourcePort(ResponseHandler* rh)
     rh->target_port_ = rh->content_;
 }
 
+//-------------------------------------------------------------------
+// Handle Request-ID header, which is added by the load balancer and
+// should be sent back in the response.
+//-------------------------------------------------------------------
+void ResponseHandler::handleRequestID(ResponseHandler* rh)
+{
+    DebugCode(std::cout << "request id: " << rh->content_ << std::endl;)
+    rh->request_id_ = rh->content_;
+}
+
+//-------------------------------------------------------------------
+// Return the request ID given by the load balancer, which is empty
+// if the request has no Request-ID header.
+//-------------------------------------------------------------------
+const std::string& ResponseHandler::getRequestID() const
+{
+    return request_id_;
+}
+
 //-------------------------------------------------------------------
 // Handle Content-Type header
 //-------------------------------------------------------------------
@@ -174,6 +208,57 @@ void ResponseHandler::getHeaderInfo()
     }
 }
 
+//-------------------------------------------------------------------
+// Read a whole file into content, under a read lock to avoid conflict
+// with PUT and DELETE. A newline in the end of the file is dropped.
+// return: -1 -- occur an error
+//         otherwise -- number of bytes in content
+//-------------------------------------------------------------------
+ssize_t ResponseHandler::readContent(int fd, std::string& content)
+{
+    // declare a read file lock
+    struct flock fl;
+    fl.l_type = F_RDLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_start = 0;
+    fl.l_len = 0;
+    fl.l_pid = 0;
+
+    // Lock the file to avoid conflict 
+    int status;
+    status = fcntl(fd, F_SETLKW, &fl);
+    if (status == -1)
+        perror("fcntl");
+
+    char buffer[HTTPMessage::HTTP_MSG_SIZE];
+    ssize_t num_read;
+    while ((num_read = read(fd, buffer, sizeof(buffer))) != 0)
+    {
+        if (num_read == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("read");
+            break;
+        }
+        content.append(buffer, num_read);
+    }
+
+    // Unlock the file
+    fl.l_type = F_UNLCK;
+    status = fcntl(fd, F_SETLKW, &fl);
+    if (status == -1) 
+        perror("fcntl");
+
+    if (num_read == -1)
+        return -1;
+
+    if (content.size() > 0 && content[content.size() - 1] == '\n')
+        content.erase(content.size() - 1);
+
+    return content.size();
+}
+
 //-------------------------------------------------------------------
 // According to the method, invoke method handler, find corresponding
 // header handler in each method's header handler table
@@ -253,42 +338,21 @@ HTTPMessage ResponseHandler::getResponse()
         return http_msg_;
     }
     
-    // declare a read file lock
-    struct flock fl;
-    fl.l_type = F_RDLCK;
-    fl.l_whence = SEEK_SET;
-    fl.l_start = 0;
-    fl.l_len = 0;
-    fl.l_pid = 0;
-
-    // The content read from the file should not be too long,
-    // because length of HTTP message is 4096
-    char buffer[HTTPMessage::HTTP_MSG_SIZE - 1096]; // 2650
-    memset(buffer, '\0', HTTPMessage::HTTP_MSG_SIZE - 1096);
-
-    // Lock the file to avoid conflict 
-    int status;
-    status = fcntl(fd, F_SETLKW, &fl);
-    if (status == -1)
-        perror("fcntl");
-    
-    ssize_t num_read = read(fd, buffer, HTTPMessage::HTTP_MSG_SIZE - 1096);
-
-    // Unlock the file
-    fl.l_type = F_UNLCK;
-    status = fcntl(fd, F_SETLKW, &fl);
-    if (status == -1) 
-        perror("fcntl");
-
-    buffer[strlen(buffer) - 1] = '\0';
+    std::string content;
+    ssize_t num_read = readContent(fd, content);
     close(fd);
+    if (num_read == -1)
+    {
+        ErrorMessage em("HTTP/1.1", StatusCode::ServerErrorStatusCode::HEAD500, target_ip_, target_port_);
+        em.constructHTTPMsg(http_msg_);
+        return http_msg_;
+    }
 
     // Construct response message
     ResponseMessage rm("HTTP/1.1", StatusCode::SuccessStatusCode::HEAD200, target_ip_, target_port_);
     rm.addContentType("text/plain");
-    std::string content_length = convertToString<int>(strlen(buffer));
-    rm.addContentLength(content_length);
-    rm.addBody(buffer);
+    rm.addContentLength(convertToString<size_t>(content.size()));
+    rm.addBody(content);
     rm.constructHTTPMsg(http_msg_);
 
     return http_msg_;
@@ -299,12 +363,16 @@ HTTPMessage ResponseHandler::getResponse()
 // the content, construct response message without the content and 
 // send it back.
 // ------------------------------------------------------------------
+// Content-Length is 0 instead of length of the file, because a 
+// receiver would wait for a body of that length, and it cannot know
+// that the message answers a HEAD request.
+// ------------------------------------------------------------------
 // Response example:
 // HTTP/1.1 200 OK
 // Target-IP: 127.0.0.1
 // Target-Port: 8080
 // Content-Type: text/plain
-// Content-Length: 15
+// Content-Length: 0
 // 
 //-------------------------------------------------------------------
 HTTPMessage ResponseHandler::headResponse()
@@ -344,41 +412,19 @@ HTTPMessage ResponseHandler::headResponse()
         return http_msg_;
     }
 
-    // declare a read file lock
-    struct flock fl;
-    fl.l_type = F_RDLCK;
-    fl.l_whence = SEEK_SET;
-    fl.l_start = 0;
-    fl.l_len = 0;
-    fl.l_pid = 0;
-
-    // The content read from the file should not be too long,
-    // because length of HTTP message is 4096
-    char buffer[HTTPMessage::HTTP_MSG_SIZE - 1096]; // 2650
-    memset(buffer, '\0', HTTPMessage::HTTP_MSG_SIZE - 1096);
-
-    // Lock the file to avoid conflict 
-    int status;
-    status = fcntl(fd, F_SETLKW, &fl);
-    if (status == -1)
-        perror("fcntl");
-    
-    ssize_t num_read = read(fd, buffer, HTTPMessage::HTTP_MSG_SIZE - 1096);
-
-    // Unlock the file
-    fl.l_type = F_UNLCK;
-    status = fcntl(fd, F_SETLKW, &fl);
-    if (status == -1) 
-        perror("fcntl");
-
-    buffer[strlen(buffer) - 1] = '\0';
+    std::string content;
+    ssize_t num_read = readContent(fd, content);
     close(fd);
+    if (num_read == -1)
+    {
+        ErrorMessage em("HTTP/1.1", StatusCode::ServerErrorStatusCode::HEAD500, target_ip_, target_port_);
+        em.constructHTTPMsg(http_msg_);
+        return http_msg_;
+    }
 
     // Construct response message
     ResponseMessage rm("HTTP/1.1", StatusCode::SuccessStatusCode::HEAD200, target_ip_, target_port_);
     rm.addContentType("text/plain");
-    std::string content_length = convertToString<int>(strlen(buffer));
-    rm.addContentLength(content_length);
     rm.constructHTTPMsg(http_msg_);
 
     return http_msg_;
@@ -499,7 +545,7 @@ HTTPMessage ResponseHandler::postResponse(std::string& body)
     std::string result = body + " is in stock";
     ResponseMessage rm("HTTP/1.1", StatusCode::SuccessStatusCode::HEAD200, target_ip_, target_port_);
     rm.addContentType("text/plain");
-    rm.addContentLength(convertToString<unsigned>(result.size() + 1));
+    rm.addContentLength(convertToString<size_t>(result.size()));
     rm.addBody(result);
     rm.constructHTTPMsg(http_msg_);
 
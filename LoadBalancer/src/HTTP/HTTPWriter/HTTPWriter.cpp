@@ -114,29 +114,56 @@ HTTPWriter& HTTPWriter::addContentLength(const std::string& content_length)
     return *this;
 }
 
+//-------------------------------------------------------------------
+// Make Content-Length header equal to the number of bytes in body, 
+// because a receiver takes exactly that many bytes after the header
+// as the body. The header is added if there is a body, and to every
+// response, since a response without it lasts until the connection
+// is closed.
+//-------------------------------------------------------------------
+void HTTPWriter::setContentLength()
+{
+    const std::string name = "Content-Length: ";
+    std::string length = std::to_string(body_.size());
+
+    size_t pos = 0;
+    while (pos < header_.size())
+    {
+        size_t line_end = header_.find("\r\n", pos);
+        if (line_end == std::string::npos)
+            line_end = header_.size();
+
+        if (header_.compare(pos, name.size(), name) == 0)
+        {
+            header_.replace(pos + name.size(), line_end - pos - name.size(), length);
+            return;
+        }
+        pos = line_end + 2;
+    }
+
+    if (body_.length() > 0 || start_line_.compare(0, 5, "HTTP/") == 0)
+        addContentLength(length);
+}
+
 //-------------------------------------------------------------------
 // turn information of a HTTPWriter object into an HTTP message
+// The message is not padded, so its length is the length of start 
+// line, header and body, and a long body makes the message grow.
 //-------------------------------------------------------------------
 void HTTPWriter::constructHTTPMsg(HTTPMessage &http_msg)
 {
-    // Before transforming, clear content in HTTP message
-    // to avoid '\0' error.
-    memset(&http_msg, '\0', sizeof(HTTPMessage)); 
-
+    setContentLength();
     start_line_ += "\r\n";
     header_ += "\r\n";
 
-    // If there is no content in body, body is not necessary, 
-    // HTTP message should end with header and "\r\n".
-    if (body_.length() > 0) 
-        body_ += "\r\n";
-    
-    // In Visual Studio 2013, sprintf() cannot pass compilation.
-#ifdef WINDOWS
-    sprintf_s(http_msg.http_msg, "%s%s%s", start_line_.c_str(), header_.c_str(), body_.c_str());
-#else
-    sprintf(http_msg.http_msg, "%s%s%s", start_line_.c_str(), header_.c_str(), body_.c_str());
-#endif
+    // If there is no content in body, HTTP message ends with header 
+    // and "\r\n". The body is not followed by "\r\n", since its 
+    // length is given by Content-Length.
+    std::string& msg = http_msg.http_msg;
+    msg.clear();
+    size_t msg_len = start_line_.size() + header_.size() + body_.size();
+    msg.reserve(msg_len > HTTPMessage::HTTP_MSG_SIZE ? msg_len : HTTPMessage::HTTP_MSG_SIZE);
+    msg.append(start_line_).append(header_).append(body_);
 }
 
 //-------------------------------------------------------------------
@@ -144,10 +171,9 @@ void HTTPWriter::constructHTTPMsg(HTTPMessage &http_msg)
 //-------------------------------------------------------------------
 void HTTPWriter::constructString(std::string &msg)
 {
+    setContentLength();
     start_line_ += "\r\n";
     header_ += "\r\n";
-    if (body_.length() > 0) 
-        body_ += "\r\n";
     
     msg = start_line_ + header_ + body_;
 }
@@ -171,6 +197,54 @@ void HTTPWriter::showInfo(const HTTPMessage& http_msg)
     cout << http_msg.http_msg << std::endl;;
 }
 
+//-------------------------------------------------------------------
+// Insert a header line, such as "Request-ID: 7", behind start line
+// of a constructed HTTP message. "\r\n" is appended to the header.
+// return: -1 -- no start line
+//          0 -- success
+//-------------------------------------------------------------------
+int HTTPWriter::insertHeader(HTTPMessage& http_msg, const char *header)
+{
+    std::string& msg = http_msg.http_msg;
+
+    size_t pos = msg.find("\r\n");
+    if (pos == std::string::npos)
+        return -1;
+
+    msg.insert(pos + 2, std::string(header) + "\r\n");
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Remove a header line, such as "Connection: keep-alive", from a 
+// constructed HTTP message, and get content of the header. Only the
+// headers are searched, not the body.
+// return: -1 -- no such header
+//          0 -- success
+//-------------------------------------------------------------------
+int HTTPWriter::removeHeader(HTTPMessage& http_msg, const char *name, std::string& content)
+{
+    std::string& msg = http_msg.http_msg;
+    std::string target = std::string("\r\n") + name + ": ";
+
+    size_t header_end = msg.find("\r\n\r\n");
+    size_t pos = msg.find(target);
+    if (pos == std::string::npos || (header_end != std::string::npos && pos > header_end))
+        return -1;
+    pos += 2;
+
+    size_t line_end = msg.find("\r\n", pos);
+    if (line_end == std::string::npos)
+        return -1;
+
+    size_t value = pos + target.size() - 2;
+    content = msg.substr(value, line_end - value);
+    msg.erase(pos, line_end + 2 - pos);
+
+    return 0;
+}
+
 
 //-------------------------------------------------------------------
 // Test case
@@ -0,0 +1,303 @@
+/////////////////////////////////////////////////////////////////////
+//  IoUring.cpp - implementation of IoUring class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "../../include/LoadBalancer/IoUring.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+IoUring::IoUring()
+    : ring_fd_(-1), sq_head_(nullptr), sq_tail_(nullptr), sq_mask_(nullptr),
+      sq_array_(nullptr), sqes_(nullptr), sq_entries_(0), sqe_tail_(0),
+      sqe_submitted_(0), cq_head_(nullptr), cq_tail_(nullptr),
+      cq_mask_(nullptr), cqes_(nullptr), sq_ring_(MAP_FAILED),
+      cq_ring_(MAP_FAILED), sq_ring_size_(0), cq_ring_size_(0), sqes_size_(0)
+{}
+
+//-------------------------------------------------------------------
+// Destructor
+//-------------------------------------------------------------------
+IoUring::~IoUring()
+{
+    destroy();
+}
+
+//-------------------------------------------------------------------
+// Create an io_uring instance with entries SQEs and map its rings.
+// return: -1 -- occur an error, io_uring may not be supported
+//          0 -- success
+//-------------------------------------------------------------------
+int IoUring::init(unsigned entries)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring_fd_ = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring_fd_ == -1)
+    {
+        ErrorHandler eh("io_uring_setup", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Since Linux 5.4, both rings can be mapped in one mmap() call.
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && cq_ring_size_ > sq_ring_size_)
+        sq_ring_size_ = cq_ring_size_;
+
+    sq_ring_ = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED)
+    {
+        ErrorHandler eh("mmap", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        destroy();
+        return -1;
+    }
+
+    if (single_mmap)
+        cq_ring_ = sq_ring_;
+    else
+    {
+        cq_ring_ = mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED)
+        {
+            ErrorHandler eh("mmap", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+            destroy();
+            return -1;
+        }
+    }
+
+    void *sqes = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        ErrorHandler eh("mmap", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        destroy();
+        return -1;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    char *sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    sqe_tail_ = sqe_submitted_ = *sq_tail_;
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Unmap the rings and close the ring fd. Operations still in flight
+// are cancelled by the kernel.
+//-------------------------------------------------------------------
+void IoUring::destroy()
+{
+    if (sqes_ != nullptr)
+        munmap(sqes_, sqes_size_);
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+        munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_ != MAP_FAILED)
+        munmap(sq_ring_, sq_ring_size_);
+    if (ring_fd_ != -1)
+        close(ring_fd_);
+
+    sqes_ = nullptr;
+    sq_ring_ = cq_ring_ = MAP_FAILED;
+    ring_fd_ = -1;
+}
+
+//-------------------------------------------------------------------
+// Register buffers, so that the kernel does not need to map them in
+// every READ_FIXED and WRITE_FIXED operation.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int IoUring::registerBuffers(char *base, unsigned count, size_t size)
+{
+    std::vector<struct iovec> iovs(count);
+    for (unsigned i = 0; i < count; i++)
+    {
+        iovs[i].iov_base = base + i * size;
+        iovs[i].iov_len = size;
+    }
+
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                iovs.data(), count) == -1)
+    {
+        ErrorHandler eh("io_uring_register", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Get a free SQE, cleared to zero.
+// Return nullptr if the submission queue is still full after the
+// prepared entries are submitted.
+//-------------------------------------------------------------------
+struct io_uring_sqe* IoUring::getSqe()
+{
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_)
+    {
+        submit(0);
+        head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (sqe_tail_ - head >= sq_entries_)
+            return nullptr;
+    }
+
+    struct io_uring_sqe *sqe = &sqes_[sqe_tail_ & *sq_mask_];
+    sqe_tail_++;
+    memset(sqe, 0, sizeof(*sqe));
+
+    return sqe;
+}
+
+//-------------------------------------------------------------------
+// Publish the prepared SQEs and enter the kernel once to submit them
+// and wait for wait_nr completions.
+// return: -1 -- occur an error
+//         otherwise -- number of submitted SQEs
+//-------------------------------------------------------------------
+int IoUring::submit(unsigned wait_nr)
+{
+    unsigned tail = *sq_tail_;
+    for (; sqe_submitted_ != sqe_tail_; sqe_submitted_++)
+    {
+        sq_array_[tail & *sq_mask_] = sqe_submitted_ & *sq_mask_;
+        tail++;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    // Entries the kernel has not consumed, including those left by an
+    // earlier partial submission.
+    unsigned to_submit = tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (to_submit == 0 && wait_nr == 0)
+        return 0;
+
+    unsigned flags = (wait_nr > 0) ? IORING_ENTER_GETEVENTS : 0;
+    int ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit, wait_nr, flags, NULL, 0);
+    if (ret == -1)
+    {
+        if (errno == EINTR)
+            return 0;
+
+        ErrorHandler eh("io_uring_enter", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    return ret;
+}
+
+//-------------------------------------------------------------------
+// Get the next completion.
+//-------------------------------------------------------------------
+bool IoUring::peekCqe(struct io_uring_cqe& cqe)
+{
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        return false;
+
+    cqe = cqes_[head & *cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Fill the fields shared by most operations
+//-------------------------------------------------------------------
+void IoUring::prepRw(struct io_uring_sqe *sqe, int op, int fd, const void *addr,
+                     unsigned len, uint64_t offset, uint64_t user_data)
+{
+    sqe->opcode = op;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(addr);
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+}
+
+//-------------------------------------------------------------------
+// Accept connections on a listen socket. One SQE produces a CQE for
+// every new connection, until a CQE without IORING_CQE_F_MORE arrives.
+//-------------------------------------------------------------------
+void IoUring::prepAcceptMultishot(struct io_uring_sqe *sqe, int fd, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_ACCEPT, fd, NULL, 0, 0, user_data);
+    sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+}
+
+//-------------------------------------------------------------------
+// Read into a registered buffer
+//-------------------------------------------------------------------
+void IoUring::prepReadFixed(struct io_uring_sqe *sqe, int fd, char *buf,
+                            unsigned len, int buf_index, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_READ_FIXED, fd, buf, len, 0, user_data);
+    sqe->buf_index = buf_index;
+}
+
+//-------------------------------------------------------------------
+// Write from a registered buffer
+//-------------------------------------------------------------------
+void IoUring::prepWriteFixed(struct io_uring_sqe *sqe, int fd, char *buf,
+                             unsigned len, int buf_index, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_WRITE_FIXED, fd, buf, len, 0, user_data);
+    sqe->buf_index = buf_index;
+}
+
+//-------------------------------------------------------------------
+// Read into a normal buffer
+//-------------------------------------------------------------------
+void IoUring::prepRead(struct io_uring_sqe *sqe, int fd, void *buf,
+                       unsigned len, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_READ, fd, buf, len, 0, user_data);
+}
+
+//-------------------------------------------------------------------
+// Write from a normal buffer
+//-------------------------------------------------------------------
+void IoUring::prepWrite(struct io_uring_sqe *sqe, int fd, const void *buf,
+                        unsigned len, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_WRITE, fd, buf, len, 0, user_data);
+}
+
+//-------------------------------------------------------------------
+// Close a file descriptor
+//-------------------------------------------------------------------
+void IoUring::prepClose(struct io_uring_sqe *sqe, int fd, uint64_t user_data)
+{
+    prepRw(sqe, IORING_OP_CLOSE, fd, NULL, 0, 0, user_data);
+}
@@ -21,10 +21,10 @@ const char* LoadBalancer::SERVER_PORT_NUM = "50000";
 // Create function to create only one instance of LoadBalancer by
 // using Singleton Pattern.
 //-------------------------------------------------------------------
-LoadBalancer* LoadBalancer::create(SchedAlgorithm sched_type)
+LoadBalancer* LoadBalancer::create(SchedAlgorithm sched_type, const BalancerConfig& config)
 {
     if (instance == nullptr) 
-        instance = new LoadBalancer(sched_type);
+        instance = new LoadBalancer(sched_type, config);
 
     return instance;
 }
@@ -33,16 +33,28 @@ LoadBalancer* LoadBalancer::create(SchedAlgorithm sched_type)
 // Constructor
 // Get scheduling algorithm type and initialize data members.
 //-------------------------------------------------------------------
-LoadBalancer::LoadBalancer(SchedAlgorithm sched_type)
+LoadBalancer::LoadBalancer(SchedAlgorithm sched_type, const BalancerConfig& config)
+    : config_(config)
 {
     lock_file_fd_ = 0;
     epoll_fd_ = 0;
     timer_fd_ = 0;
     listen_fd_ = 0;
     signal_fd_ = 0;
-    FD_ZERO(&server_fds_);
     balancer_run_ = true;
     algorithm_selector_ = new AlgorithmSelector(sched_type);
+    worker_index_ = 0;
+    latency_decay_time_ = 0;
+    uring_running_ = false;
+
+    if (config_.worker_count < 1)
+        config_.worker_count = 1;
+    if (config_.worker_count > MAX_WORKERS)
+        config_.worker_count = MAX_WORKERS;
+    if (config_.pool_size < 1)
+        config_.pool_size = 1;
+    if (config_.pool_size > MAX_POOL_SIZE)
+        config_.pool_size = MAX_POOL_SIZE;
 }
 
 //-------------------------------------------------------------------
@@ -55,7 +67,6 @@ LoadBalancer::~LoadBalancer()
     timer_fd_ = 0;
     listen_fd_ = 0;
     signal_fd_ = 0;
-    FD_ZERO(&server_fds_);
     balancer_run_ = false;
     delete algorithm_selector_;
 }
@@ -63,6 +74,8 @@ LoadBalancer::~LoadBalancer()
 //-------------------------------------------------------------------
 // Entry point of the whole work of a load balancer. This function
 // invokes other relative functions.
+// With one worker, the event loop runs in this process. Otherwise,
+// this process becomes the master and forks the workers.
 //-------------------------------------------------------------------
 void LoadBalancer::start()
 {
@@ -70,9 +83,49 @@ void LoadBalancer::start()
     if (lock_file_fd_ == -1)
         return;
 
-    // Select scheduling algorithm by sched_type;
+    // Select scheduling algorithm by sched_type. It reads the servers
+    // from server_table_, which is filled by each worker.
+    algorithm_selector_->setServerTable(&server_table_);
     algorithm_selector_->selectAlgorithm();
+    algorithm_selector_->setLoadBound(config_.hash_load_bound);
+    if (config_.expire_time > 0)
+        algorithm_selector_->setExpireTime(config_.expire_time);
 
+    // The load table must be created before workers are forked, so
+    // that all of them share the same counters.
+    if (load_table_.create(MAX_REAL_SERVER, config_.worker_count) == -1)
+        return;
+
+    if (config_.worker_count == 1)
+    {
+        startWorker();
+        load_table_.destroy();
+        return;
+    }
+
+    if (initMasterSignalfd() == FATAL_ERROR)
+        return;
+
+    worker_pids_.assign(config_.worker_count, 0);
+    for (int i = 0; i < config_.worker_count; i++)
+    {
+        if (forkWorker(i) == FATAL_ERROR)
+        {
+            stopWorkers();
+            return;
+        }
+    }
+
+    std::cout << "Load balancer runs " << config_.worker_count << " workers\n";
+    superviseWorkers();
+}
+
+//-------------------------------------------------------------------
+// Event loop of a worker. A worker connects to real servers, listens
+// to clients and handles all the events of its own fds.
+//-------------------------------------------------------------------
+void LoadBalancer::startWorker()
+{
     struct itimerspec ts;
 
     // initialize relative file descriptors
@@ -80,11 +133,33 @@ void LoadBalancer::start()
         initSignalfd() == FATAL_ERROR ||
         connectRealServers() == FATAL_ERROR ||
         initTimerfd(ts) == FATAL_ERROR ||
+        initIdleTimer() == FATAL_ERROR ||
+        initRequestTimer() == FATAL_ERROR ||
         initListenfd() == FATAL_ERROR)
         return;
 
     DebugCode(listRealServers();)
 
+    // The io_uring engine does not handle tunnels of passthrough mode.
+    if (config_.io_uring && !config_.passthrough && initUring() == SUCCESS)
+        runUringLoop(ts);
+    else
+    {
+        if (config_.io_uring)
+            std::cout << "io_uring engine is not used, use epoll instead.\n";
+        runEpollLoop(ts);
+    }
+
+    // clear all the resources and exit
+    clearAll();
+}
+
+//-------------------------------------------------------------------
+// Event loop based on epoll. Every event is handled by read(), write()
+// and other system calls invoked one by one.
+//-------------------------------------------------------------------
+void LoadBalancer::runEpollLoop(struct itimerspec& ts)
+{
     struct epoll_event evlist[MAX_EVENTS];
     int ready;
     int trigger_fd;
@@ -121,7 +196,10 @@ void LoadBalancer::start()
             // Get a request from a client
             if ((trigger_fd == listen_fd_) & evlist[i].events & EPOLLIN)
             {
-                ret = handleRequestFromClient();
+                if (config_.passthrough)
+                    ret = acceptTunnel();
+                else
+                    ret = acceptClient();
 
                 if (ret == Status::MINOR_ERROR)
                     continue;
@@ -132,10 +210,20 @@ void LoadBalancer::start()
                 }
             }
 
-            // get response from a real server
-            else if ((FD_ISSET(trigger_fd, &server_fds_)) & evlist[i].events & EPOLLIN)
+            // get response from a real server, or send requests left
+            // in its buffer. Client fds may be above FD_SETSIZE, so
+            // server fds are found by lookups, not in an fd_set.
+            else if (server_table_.find(trigger_fd) != -1 ||
+                     conn_servers_.find(trigger_fd) != conn_servers_.end())
             {
-                ret = handleResultFromServer(trigger_fd);
+                ret = Status::SUCCESS;
+                if ((evlist[i].events & EPOLLOUT) && flushServer(trigger_fd) != SUCCESS)
+                {
+                    handleServerClosed(trigger_fd);
+                    ret = (server_table_.count() > 0) ? Status::MINOR_ERROR : Status::FATAL_ERROR;
+                }
+                else if (evlist[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    ret = handleResultFromServer(trigger_fd);
 
                 if (ret == Status::MINOR_ERROR)
                     continue;
@@ -176,6 +264,57 @@ void LoadBalancer::start()
                 handleSignal();
             }
 
+            // get requests from a client connection, or send responses
+            // left in its buffer
+            else if (client_conns_.find(trigger_fd) != client_conns_.end())
+            {
+                ret = Status::SUCCESS;
+                if (evlist[i].events & EPOLLOUT)
+                    flushClient(trigger_fd);
+
+                if (client_conns_.find(trigger_fd) != client_conns_.end() &&
+                    (evlist[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                    ret = handleRequestFromClient(trigger_fd);
+
+                if (ret == Status::FATAL_ERROR)
+                {
+                    balancer_run_ = false;
+                    break;
+                }
+            }
+
+            // idle client connections time out
+            else if ((trigger_fd == idle_timers_.getTimerfd()) & evlist[i].events & EPOLLIN)
+            {
+                handleIdleTimeout();
+            }
+
+            // requests wait too long for their responses
+            else if ((trigger_fd == request_timers_.getTimerfd()) & evlist[i].events & EPOLLIN)
+            {
+                std::vector<uint64_t> expired;
+                request_timers_.getExpired(expired);
+                handleRequestTimeout(expired);
+            }
+
+            // a probe of health check times out
+            else if ((probe_timers_.find(trigger_fd) != probe_timers_.end()) & evlist[i].events & EPOLLIN)
+            {
+                ret = handleProbeTimeout(trigger_fd);
+
+                if (ret == Status::FATAL_ERROR)
+                {
+                    balancer_run_ = false;
+                    break;
+                }
+            }
+
+            // a client or a real server of a tunnel is readable or writable
+            else if (tunnel_map_.find(trigger_fd) != tunnel_map_.end())
+            {
+                handleTunnel(trigger_fd);
+            }
+
             // occur an error
             else
             {
@@ -184,9 +323,6 @@ void LoadBalancer::start()
             }
         }
     }
-
-    // clear all the resources and exit
-    clearAll();
 }
 
 //-------------------------------------------------------------------
@@ -210,11 +346,12 @@ Status LoadBalancer::initEpollfd()
 //-------------------------------------------------------------------
 Status LoadBalancer::initSignalfd()
 {
-    // Can catch SIGINT and SIGTERM
+    // Can catch SIGINT, SIGTERM, and SIGHUP to reload configuration
     sigset_t mask;
     sigemptyset(&mask);
     sigaddset(&mask, SIGTERM);
     sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGHUP);
 
     if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
     {
@@ -236,6 +373,179 @@ Status LoadBalancer::initSignalfd()
     return SUCCESS;
 }
 
+//-------------------------------------------------------------------
+// Initialize signal fd of the master. Besides SIGINT and SIGTERM,
+// the master catches SIGCHLD to know that a worker terminates, and
+// SIGHUP to pass to the workers. Workers inherit the signal mask.
+//-------------------------------------------------------------------
+Status LoadBalancer::initMasterSignalfd()
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGCHLD);
+    sigaddset(&mask, SIGHUP);
+
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
+    {
+        ErrorHandler eh("sigprocmask", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return FATAL_ERROR;
+    }
+
+    signal_fd_ = signalfd(-1, &mask, 0);
+    if (signal_fd_ == -1)
+    {
+        ErrorHandler eh("signalfd", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return FATAL_ERROR;
+    }
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Fork a worker. The worker closes the master's signal fd and runs
+// its own event loop.
+//-------------------------------------------------------------------
+Status LoadBalancer::forkWorker(int index)
+{
+    // Flush the output, otherwise it would be printed again by the child.
+    fflush(stdout);
+
+    pid_t pid;
+    switch (pid = fork())
+    {
+    case -1:
+    {
+        ErrorHandler eh("fork", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return FATAL_ERROR;
+    }
+    case 0: // worker
+        close(signal_fd_);
+        signal_fd_ = 0;
+        worker_index_ = index;
+        worker_pids_.clear();
+        std::cout << "worker " << index << " starts, pid = " << getpid() << std::endl;
+
+        // startWorker() only returns when the worker meets a fatal error. 
+        startWorker();
+        _exit(EXIT_FAILURE);
+    default: // master
+        worker_pids_[index] = pid;
+        break;
+    }
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Work of the master. The master waits for signals. When a worker is
+// killed by a signal, its requests are taken out of the load table and
+// a new worker is forked. A worker which exits by itself has met a 
+// fatal error (e.g. no real server is available) and is not restarted.
+// SIGHUP is passed to every worker, which reloads configuration in its
+// own event loop. The master reads the configuration too, so that a
+// worker forked after it has the same configuration.
+//-------------------------------------------------------------------
+void LoadBalancer::superviseWorkers()
+{
+    struct signalfd_siginfo fdsi;
+    int alive = config_.worker_count;
+
+    while (balancer_run_)
+    {
+        ssize_t s = read(signal_fd_, &fdsi, sizeof(fdsi));
+        if (s == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+            break;
+        }
+
+        switch (fdsi.ssi_signo)
+        {
+        case SIGCHLD:
+        {
+            int status;
+            pid_t pid;
+            while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+            {
+                for (int i = 0; i < config_.worker_count; i++)
+                {
+                    if (worker_pids_[i] != pid)
+                        continue;
+
+                    std::cout << "worker " << i << " (pid " << pid << ") terminates\n";
+                    worker_pids_[i] = 0;
+                    load_table_.releaseWorker(i);
+                    alive--;
+
+                    if (WIFSIGNALED(status) && forkWorker(i) == SUCCESS)
+                        alive++;
+                    break;
+                }
+            }
+
+            if (alive <= 0)
+            {
+                std::cout << "No worker is running.\n";
+                balancer_run_ = false;
+            }
+            break;
+        }
+        case SIGHUP:
+            std::cout << "catch SIGHUP, workers reload configuration\n";
+            reloadMasterConfig();
+            for (auto pid : worker_pids_)
+            {
+                if (pid > 0)
+                    kill(pid, SIGHUP);
+            }
+            break;
+        case SIGTERM:
+        case SIGINT:
+            std::cout << "catch SIGINT\n";
+            balancer_run_ = false;
+            break;
+        default:
+            std::cout << "Unknown signal " << fdsi.ssi_signo << std::endl;
+            break;
+        }
+    }
+
+    stopWorkers();
+}
+
+//-------------------------------------------------------------------
+// Terminate all the workers, wait for them and clear resources of 
+// the master.
+//-------------------------------------------------------------------
+void LoadBalancer::stopWorkers()
+{
+    for (auto pid : worker_pids_)
+    {
+        if (pid > 0)
+            kill(pid, SIGTERM);
+    }
+
+    for (auto pid : worker_pids_)
+    {
+        if (pid > 0)
+            waitpid(pid, NULL, 0);
+    }
+    worker_pids_.clear();
+
+    std::cout << "Load Balancer master shuts down...\n";
+    close(signal_fd_);
+    close(lock_file_fd_);
+    load_table_.destroy();
+}
+
 //-------------------------------------------------------------------
 // Initialize timer fd
 //-------------------------------------------------------------------
@@ -268,6 +578,32 @@ Status LoadBalancer::initTimerfd(struct itimerspec& ts)
     return SUCCESS;
 }
 
+//-------------------------------------------------------------------
+// Initialize the timer fd of idle client connections
+//-------------------------------------------------------------------
+Status LoadBalancer::initIdleTimer()
+{
+    if (idle_timers_.init(CLIENT_IDLE_TIME_OUT) == -1)
+        return FATAL_ERROR;
+
+    addEvent(epoll_fd_, idle_timers_.getTimerfd(), OneShotType::NON_ONESHOT, BlockType::NON_BLOCK);
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Initialize the timer wheel of requests sent to real servers
+//-------------------------------------------------------------------
+Status LoadBalancer::initRequestTimer()
+{
+    if (request_timers_.init(REQUEST_TIMER_TICK) == -1)
+        return FATAL_ERROR;
+
+    addEvent(epoll_fd_, request_timers_.getTimerfd(), OneShotType::NON_ONESHOT, BlockType::NON_BLOCK);
+
+    return SUCCESS;
+}
+
 //-------------------------------------------------------------------
 // Initialize listen fd
 //-------------------------------------------------------------------
@@ -276,7 +612,12 @@ Status LoadBalancer::initListenfd()
     SocketCreator sc;
     socklen_t addrlen;
 
-    listen_fd_ = sc.inetListen(BIND_ADDRESS, PORT_NUM, BACKLOG, &addrlen);
+    // Every worker owns a listen socket on the same port, and the kernel
+    // distributes new connections among them.
+    if (config_.worker_count > 1)
+        listen_fd_ = sc.inetReusePortListen(BIND_ADDRESS, PORT_NUM, BACKLOG, &addrlen);
+    else
+        listen_fd_ = sc.inetListen(BIND_ADDRESS, PORT_NUM, BACKLOG, &addrlen);
     if (listen_fd_ == -1)
     {
         fprintf(stderr, "socket inetListen error\n");
@@ -292,6 +633,8 @@ Status LoadBalancer::initListenfd()
 // Try to connect different real servers by sending HTTP message with
 // method of SERVERCHECK, and check whether there is a server can
 // send a response back with information of max load.
+// This connection becomes the control connection of the server, and
+// its fd is the key of the server in server_table_.
 //-------------------------------------------------------------------
 Status LoadBalancer::connectRealServers()
 {
@@ -314,24 +657,21 @@ Status LoadBalancer::connectRealServers()
 
         ServerCheckMethodWriter scmw(host_buf, "HTTP/1.1", host_buf, BIND_ADDRESS, PORT_NUM);
         scmw.constructHTTPMsg(check_msg);
-        if (write(cfd, check_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
+        if (ConnBuffer::writeFull(cfd, check_msg.http_msg.data(), check_msg.http_msg.size()) == -1)
         {
             ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
             eh.errMsg();
             return FATAL_ERROR;
         }
 
+        // The socket is still blocking, so the whole response is read
+        // here. Bytes behind the response stay in the buffer of the 
+        // connection.
         HTTPMessage recv_msg;
-        ssize_t num_read = read(cfd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-        if (num_read == -1)
-        {
-            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
-            eh.errMsg();
-            return Status::FATAL_ERROR;
-        }
-        if (num_read == 0) 
+        if (!server_buffers_[cfd].waitMessage(cfd, recv_msg))
         {
             fprintf(stderr, "Unexpected EOF from a server\n");
+            server_buffers_.erase(cfd);
             return Status::FATAL_ERROR;
         }
 
@@ -344,26 +684,47 @@ Status LoadBalancer::connectRealServers()
         int max_load = convertStringToInt(msg_body);
         std::cout << "Max load of server " << host_buf << " is " << max_load << std::endl;
 
-        addEvent(epoll_fd_, cfd, OneShotType::NON_ONESHOT, BlockType::BLOCK);
-        FD_SET(cfd, &server_fds_);
+        if (addProbe(cfd) != SUCCESS)
+        {
+            server_buffers_.erase(cfd);
+            close(cfd);
+            continue;
+        }
 
-        // a real server's information: IP address, port number, max_load, cur_load
-        RealServer real_server = { host_buf, SERVER_PORT_NUM, max_load, 0 };
-        server_pool_.insert(std::pair<int, RealServer>(cfd, real_server));
+        addEvent(epoll_fd_, cfd, OneShotType::NON_ONESHOT, BlockType::BLOCK);
+        server_buffers_[cfd].setEvents(EPOLLIN);
+
+        // a real server's information: IP address, port number, max_load, cur_load,
+        // latency and the time of its last sample
+        // Its index is the same in server table and in load table. The
+        // max load in load table is kept if it has been reloaded.
+        max_load = load_table_.setServer(i - 1, max_load);
+        RealServer real_server = { host_buf, SERVER_PORT_NUM, max_load, 0, 0.0, 0 };
+        server_table_.add(cfd, real_server, i - 1);
+
+        // Open the connection pool for requests. A connection which
+        // cannot be opened now is tried again when it is selected.
+        if (!config_.passthrough)
+        {
+            PoolConnection conn = { -1, 0 };
+            conn_pools_[cfd].assign(config_.pool_size, conn);
+            for (auto& x : conn_pools_[cfd])
+                openConnection(cfd, x);
+        }
     }
 
     // If no real server is available, terminate load balancer. 
-    if (server_pool_.size() <= 0)
+    if (server_table_.count() <= 0)
         return Status::FATAL_ERROR;
 
     return Status::SUCCESS;
 }
 
 //-------------------------------------------------------------------
-// Receive a request from a client, check the server_pool_ to find an
-// appropriate server and send request to the server.
+// Accept a client connection. The connection is added to epoll fd,
+// and its requests are read when it is readable.
 //-------------------------------------------------------------------
-Status LoadBalancer::handleRequestFromClient()
+Status LoadBalancer::acceptClient()
 {
     socklen_t addrlen;
     struct sockaddr_storage claddr;
@@ -380,45 +741,174 @@ Status LoadBalancer::handleRequestFromClient()
     }
     std::cout << "Load balancer accepts client's fd: " << cfd << std::endl;
 
+    // get client's IP address and port number 
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    if (getSourceInfo((struct sockaddr*)&claddr, addrlen, host, service) == MINOR_ERROR)
+    {
+        close(cfd);
+        return MINOR_ERROR;
+    }
+
+    ClientConnection& client = client_conns_[cfd];
+    snprintf(client.client_addr, sizeof(client.client_addr), "%s", host);
+    snprintf(client.client_port, sizeof(client.client_port), "%s", service);
+    client.closing = false;
+    client.buffer.setEvents(EPOLLIN);
+
+    addEventMask(epoll_fd_, cfd, EPOLLIN, BlockType::NON_BLOCK);
+
+    // A client which connects and sends nothing is closed as idle.
+    idle_timers_.start(cfd);
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Read a client connection, and handle every complete request in its
+// buffer. A request split in several reads stays in the buffer until
+// the rest arrives.
+// The responses are sent back in order of requests of the connection.
+//-------------------------------------------------------------------
+Status LoadBalancer::handleRequestFromClient(int trigger_fd)
+{
+    ConnBuffer::ReadState state = client_conns_[trigger_fd].buffer.readFrom(trigger_fd);
+    if (state == ConnBuffer::READ_ERROR)
+    {
+        closeClient(trigger_fd);
+        return MINOR_ERROR;
+    }
+
     HTTPMessage recv_msg;
-    memset(recv_msg.http_msg, '\0', HTTPMessage::HTTP_MSG_SIZE);
+    while (true)
+    {
+        // The client may be closed by an error response.
+        auto it = client_conns_.find(trigger_fd);
+        if (it == client_conns_.end())
+            return MINOR_ERROR;
+        if (it->second.closing || !it->second.buffer.getMessage(recv_msg))
+            break;
 
-    ssize_t num_read = read(cfd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-    if (num_read == -1) 
+        if (handleRequest(trigger_fd, recv_msg) == FATAL_ERROR)
+            return FATAL_ERROR;
+    }
+
+    // A message which cannot be framed makes the rest of the stream
+    // meaningless.
+    state = client_conns_[trigger_fd].buffer.getReadState();
+    if (state == ConnBuffer::READ_ERROR)
     {
-        ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
-        eh.errMsg();
+        closeClient(trigger_fd);
         return MINOR_ERROR;
     }
-    if (num_read == 0) 
+
+    if (state == ConnBuffer::READ_EOF)
     {
         fprintf(stderr, "EOF of client\n");
+
+        // The client sends no more requests, but responses of its requests
+        // being handled are still sent back.
+        ClientConnection& client = client_conns_[trigger_fd];
+        client.closing = true;
+        if (client.responses.empty() && !client.buffer.hasOutput())
+        {
+            closeClient(trigger_fd);
+            return MINOR_ERROR;
+        }
+        watchOutput(trigger_fd, client.buffer, false);
+    }
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Handle one request of a client connection: check the server_table_ 
+// to find an appropriate server and send request to the server.
+//-------------------------------------------------------------------
+Status LoadBalancer::handleRequest(int cfd, HTTPMessage& recv_msg)
+{
+    ClientConnection& client = client_conns_[cfd];
+    idle_timers_.stop(cfd);
+
+    client.responses.resize(client.responses.size() + 1);
+    PendingResponse& pending = client.responses.back();
+    pending.request_id = RequestTable::INVALID_ID;
+    pending.ready = false;
+    pending.keep_alive = getKeepAlive(recv_msg);
+
+    // A request without keep-alive is the last one of the connection.
+    // The requests behind it in the buffer are dropped.
+    if (!pending.keep_alive)
+    {
+        client.closing = true;
+        watchOutput(cfd, client.buffer, false);
+    }
+
+    // Copy the address, because the connection may be closed when an 
+    // error response is sent.
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    snprintf(host, sizeof(host), "%s", client.client_addr);
+    snprintf(service, sizeof(service), "%s", client.client_port);
+
+    int conn_fd;
+    RequestTable::RequestID request_id;
+    Status ret = prepareRequest(cfd, host, service, recv_msg, conn_fd, request_id);
+    if (ret != SUCCESS)
+        return ret;
+
+    client_conns_[cfd].responses.back().request_id = request_id;
+
+    // Send the request to a server
+    if (sendToServer(conn_fd, recv_msg) != SUCCESS)
+    {
+        // The connection is broken. This request and other requests sent
+        // on it get error responses, and the connection is opened again
+        // when it is selected next time.
+        dropConnection(conn_fd);
+
         return Status::MINOR_ERROR;
     }
 
+    listRealServers();
+
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Prepare a request received from a client: select a real server by
+// the scheduling algorithm and a connection in its pool, put the 
+// request into request table and add its ID to the message. The load
+// of the request is counted here, and the message is sent on conn_fd
+// by the caller.
+// If the request cannot be handled, an error response is sent to the
+// client and MINOR_ERROR is returned.
+//-------------------------------------------------------------------
+Status LoadBalancer::prepareRequest(int cfd, const char *host, const char *service,
+                                    HTTPMessage& recv_msg, int& conn_fd,
+                                    RequestTable::RequestID& request_id)
+{
     std::cout << "===========================================\n";
     std::cout << "Load Balancer receive a request from client:\n";
     std::cout << recv_msg.http_msg;
     std::cout << "===========================================\n";
 
-    // get client's IP address and port number 
     RequestInfo request;
-    char host[NI_MAXHOST], service[NI_MAXSERV];
-    if (getSourceInfo((struct sockaddr*)&claddr, addrlen, host, service) == SUCCESS)
-        request.client_addr = host;
-    else
-        return MINOR_ERROR;
-
+    snprintf(request.client_addr, sizeof(request.client_addr), "%s", host);
+    snprintf(request.client_port, sizeof(request.client_port), "%s", service);
     request.client_fd = cfd;
 
-    int handle_fd;
-
     // Select an appropriate real server.
-    if (server_pool_.size() > 0)
+    int handle_fd;
+    if (server_table_.count() > 0)
     {
-        // update scheduling algorithm's server pool
-        algorithm_selector_->setSchedMap(server_pool_);
-        handle_fd = algorithm_selector_->selectServer();
+        // The scheduling algorithm reads server_table_ directly.
+        // Hashing algorithms map the client's address to a server,
+        // and LBLC maps the URL.
+        std::string url;
+        getRequestURL(recv_msg, url);
+        syncServerLoad();
+        algorithm_selector_->setHandleIP(host);
+        algorithm_selector_->setHandleURL(url);
+        handle_fd = reserveServer();
     }
     else
     {
@@ -428,47 +918,56 @@ Status LoadBalancer::handleRequestFromClient()
 
     if (handle_fd == -1 || handle_fd == 0)
     {
-        std::string error_code;
         if (handle_fd == -1)
         {
             std::cout << "cannot handle any requests" << std::endl;
-            error_code = StatusCode::ServerErrorStatusCode::HEAD503;
+            replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD503, host, service);
         }
         else
         {
             std::cout << "format is not correct" << std::endl;
-            error_code = StatusCode::ServerErrorStatusCode::HEAD500;
+            replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD500, host, service);
         }
-
-        HTTPMessage send_msg;
-        ResponseMessage rm("HTTP/1.1", error_code, host, service);
-        rm.constructHTTPMsg(send_msg);
-        write(cfd, send_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
         return Status::MINOR_ERROR;
     }
 
-    // Send the request to a server
-    if (write(handle_fd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
+    conn_fd = selectConnection(handle_fd);
+    if (conn_fd == -1)
     {
-        ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
-        eh.errMsg();
-        
-        // Because there is an error in the server, delete resources of this
-        // server in load balancer.
-        deleteEvent(epoll_fd_, handle_fd);
-        FD_CLR(handle_fd, &server_fds_);
-        server_pool_.erase(handle_fd);
-        close(handle_fd);
-
+        std::cout << "cannot connect to real server " << getServer(handle_fd).address << std::endl;
+        cancelReservation(handle_fd);
+        replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD503, host, service);
         return Status::MINOR_ERROR;
     }
 
-    // Because load balancer has just sent a request, the server's current
-    // load should increment 1.
-    server_pool_[handle_fd].cur_load += 1;
-
-    listRealServers();
-    request_map_.insert(std::pair<std::string, RequestInfo>(service, request));
+    // Put the request into request table, and add its ID to the message.
+    // The real server will send the ID back in the response.
+    request.server_fd = handle_fd;
+    request.conn_fd = conn_fd;
+    request.send_time = getMonotonicTime();
+    request_id = request_table_.insert(request);
+    if (request_id == RequestTable::INVALID_ID)
+    {
+        std::cout << "too many requests" << std::endl;
+        cancelReservation(handle_fd);
+        replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD503, host, service);
+        return Status::MINOR_ERROR;
+    }
+
+    char id_header[32];
+    snprintf(id_header, sizeof(id_header), "Request-ID: %u", request_id);
+    if (HTTPWriter::insertHeader(recv_msg, id_header) == -1)
+    {
+        std::cout << "format is not correct" << std::endl;
+        request_table_.erase(request_id);
+        cancelReservation(handle_fd);
+        replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD500, host, service);
+        return Status::MINOR_ERROR;
+    }
+
+    addLoad(request);
+    request_timers_.start(RequestTable::getIndex(request_id), request_id,
+                          REQUEST_TIME_OUT * 1000);
 
     return Status::SUCCESS;
 }
@@ -480,172 +979,1320 @@ Status LoadBalancer::handleRequestFromClient()
 //-------------------------------------------------------------------
 Status LoadBalancer::handleResultFromServer(int trigger_fd)
 {
+    ConnBuffer& buffer = server_buffers_[trigger_fd];
+    ConnBuffer::ReadState state = buffer.readFrom(trigger_fd);
+
+    // Handle the responses read before the end of the connection.
     HTTPMessage recv_msg;
-    memset(recv_msg.http_msg, '\0', HTTPMessage::HTTP_MSG_SIZE);
+    while (buffer.getMessage(recv_msg))
+    {
+        RequestTable::RequestID request_id = getRequestID(recv_msg);
+        int target_fd = matchResponse(recv_msg);
+        if (target_fd != -1)
+            completeResponse(target_fd, request_id, recv_msg);
+    }
 
-    ssize_t num_read = read(trigger_fd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-    if (num_read == -1 || num_read == 0)
+    state = buffer.getReadState();
+    if (state != ConnBuffer::READ_OPEN)
     {
-        if (num_read == -1)
-        {
-            ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
-            eh.errMsg();
-        }
-        else
+        if (state == ConnBuffer::READ_EOF)
             fprintf(stderr, "unexpected EOF of a real server\n");
 
-        // Because a real server meets an error, delete the resources of
-        // this server in load balancer.
-        deleteEvent(epoll_fd_, trigger_fd);
-        FD_CLR(trigger_fd, &server_fds_);
-        server_pool_.erase(trigger_fd);
-        close(trigger_fd);
-
-        if (server_pool_.size() <= 0)
+        handleServerClosed(trigger_fd);
+        if (server_table_.count() <= 0)
             return Status::FATAL_ERROR;
 
         return Status::MINOR_ERROR;
     }
 
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// A connection to a real server is broken. A pooled connection is 
+// opened again later. If the control connection breaks, the real 
+// server is regarded as dead, and the resources of this server are
+// deleted.
+//-------------------------------------------------------------------
+void LoadBalancer::handleServerClosed(int fd)
+{
+    if (conn_servers_.find(fd) != conn_servers_.end())
+        dropConnection(fd);
+    else if (server_table_.find(fd) != -1)
+        removeServer(fd);
+}
+
+//-------------------------------------------------------------------
+// Send a message on a connection to a real server. What cannot be 
+// sent now is sent when the connection becomes writable.
+//-------------------------------------------------------------------
+Status LoadBalancer::sendToServer(int fd, const HTTPMessage& msg)
+{
+    ConnBuffer& buffer = server_buffers_[fd];
+    buffer.queueMessage(msg);
+
+    return flushServer(fd);
+}
+
+//-------------------------------------------------------------------
+// Send the pending output of a connection to a real server. The 
+// connection waits for EPOLLOUT only while output is pending.
+// return: MINOR_ERROR -- the connection is broken, and the caller
+//                        should close it
+//         SUCCESS -- otherwise
+//-------------------------------------------------------------------
+Status LoadBalancer::flushServer(int fd)
+{
+    ConnBuffer& buffer = server_buffers_[fd];
+    if (buffer.flushTo(fd) == -1)
+        return MINOR_ERROR;
+
+    watchOutput(fd, buffer, true);
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Update the events of a connection in epoll fd: EPOLLIN if it is 
+// still read, and EPOLLOUT if it has pending output.
+//-------------------------------------------------------------------
+void LoadBalancer::watchOutput(int fd, ConnBuffer& buffer, bool reading)
+{
+    uint32_t events = (reading ? static_cast<uint32_t>(EPOLLIN) : 0u) |
+                      (buffer.hasOutput() ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (events != buffer.getEvents())
+    {
+        modifyEvent(epoll_fd_, fd, events);
+        buffer.setEvents(events);
+    }
+}
+
+//-------------------------------------------------------------------
+// Find the request of a response from a real server by its request
+// ID, remove the request and decrement load of the server.
+// return: -1 -- no request is found
+//         otherwise -- the client's file descriptor
+//-------------------------------------------------------------------
+int LoadBalancer::matchResponse(const HTTPMessage& recv_msg)
+{
     std::cout << "Load Balancer receive response:\n";
     std::cout << recv_msg.http_msg;
 
-    int target_fd = 0;
-    getTargetIP(recv_msg, target_ip_);
-    getTargetPort(recv_msg, target_port_);
-    std::cout << "Target IP: " << target_ip_ << std::endl;
-    std::cout << "Target Port: " << target_port_ << std::endl;
+    DebugCode(listRequests();)
+
+    // Find target client by request ID
+    RequestTable::RequestID request_id = getRequestID(recv_msg);
+    RequestInfo *request = request_table_.find(request_id);
+
+    // When request is nullptr, it means that either there's no Request-ID
+    // in the response, or the request has been removed. A child of a real
+    // server terminates, or the client closes its connection, can usually
+    // cause this happen. Under this situation, no response needed to be
+    // returned.
+    if (request == nullptr)
+    {
+        std::cout << "A child of a real server terminates.\n";
+        return -1;
+    }
+
+    recordLatency(*request);
+
+    // A response of health check is not sent to any client.
+    if (request->client_fd == -1)
+    {
+        handleProbeResult(request->server_fd, request_id, recv_msg);
+        return -1;
+    }
+
+    int target_fd = request->client_fd;
+
+    std::cout << "request id is " << request_id << "\n target client_fd = " << target_fd << std::endl;
+
+    // Because a real server has just finished a request, decrement
+    // current load by 1.
+    finishRequest(request_id);
+
+    listRealServers();
 
-    listRequests();
+    return target_fd;
+}
 
-    // Find target client by IP address and port number
-    std::pair<RequestMap::iterator, RequestMap::iterator> ret;
-    ret = request_map_.equal_range(target_port_);
-    for (RequestMap::iterator it = ret.first; it != ret.second; it++)
+//-------------------------------------------------------------------
+// Select a real server by the scheduling algorithm, and reserve a slot
+// of it in the load table. Another worker may take the last slot of
+// the server after the loads were copied, then the load of the server
+// is copied again and another server is selected.
+// return: >0  fd of the real server
+//         -1  no real server is available
+//          0  error of the scheduling algorithm
+//-------------------------------------------------------------------
+int LoadBalancer::reserveServer()
+{
+    for (int i = 0; i < RESERVE_ATTEMPTS; i++)
     {
-        if (it->second.client_addr == target_ip_)
+        int handle_fd = algorithm_selector_->selectServer();
+        if (handle_fd <= 0)
+            return handle_fd;
+
+        int index = server_table_.find(handle_fd);
+        if (index == -1)
+            return 0;
+
+        int load = load_table_.reserve(worker_index_, index,
+                                       AbstractSchedAlgorithms::RESERVED_CAPACITY);
+        if (load != -1)
         {
-            target_fd = it->second.client_fd;
-            request_map_.erase(it); 
-            break;
+            server_table_.setLoad(index, load);
+            return handle_fd;
+        }
+
+        server_table_.setLoad(index, load_table_.getLoad(index));
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------------------
+// Give back the slot reserved for a request which is not sent.
+//-------------------------------------------------------------------
+void LoadBalancer::cancelReservation(int server_fd)
+{
+    int index = server_table_.find(server_fd);
+    if (index != -1)
+        server_table_.setLoad(index, load_table_.decrement(worker_index_, index));
+}
+
+//-------------------------------------------------------------------
+// Count a request in the requests in flight on its connection. Its
+// load has been counted when its real server was reserved.
+//-------------------------------------------------------------------
+void LoadBalancer::addLoad(const RequestInfo& request)
+{
+    PoolConnection *conn = findConnection(request.conn_fd);
+    if (conn != nullptr)
+        conn->in_flight++;
+}
+
+//-------------------------------------------------------------------
+// Measure the time from sending a request to its response, or to its
+// time out, and add it to the response time of its real server. Probes
+// are measured too, so a server which gets no requests still has its
+// response time updated.
+//-------------------------------------------------------------------
+void LoadBalancer::recordLatency(const RequestInfo& request)
+{
+    int index = server_table_.find(request.server_fd);
+    if (index == -1)
+        return;
+
+    uint64_t now = getMonotonicTime();
+    uint64_t rtt = (now > request.send_time) ? now - request.send_time : 0;
+    server_table_.setLatency(index, load_table_.addLatency(worker_index_, index, rtt, now), now);
+}
+
+//-------------------------------------------------------------------
+// Take a finished or failed request out of the loads.
+//-------------------------------------------------------------------
+void LoadBalancer::removeLoad(const RequestInfo& request)
+{
+    int index = server_table_.find(request.server_fd);
+    if (index != -1)
+        server_table_.setLoad(index, load_table_.decrement(worker_index_, index));
+
+    PoolConnection *conn = findConnection(request.conn_fd);
+    if (conn != nullptr)
+        conn->in_flight--;
+}
+
+//-------------------------------------------------------------------
+// Remove a request sent to a real server from request table, together
+// with its load and its timer.
+//-------------------------------------------------------------------
+void LoadBalancer::finishRequest(RequestTable::RequestID request_id)
+{
+    RequestInfo *request = request_table_.find(request_id);
+    if (request == nullptr)
+        return;
+
+    request_timers_.stop(RequestTable::getIndex(request_id));
+    removeLoad(*request);
+    request_table_.erase(request_id);
+}
+
+//-------------------------------------------------------------------
+// A request will never be answered. Remove it and send an error 
+// response to its client, which is closed unless it is kept.
+//-------------------------------------------------------------------
+void LoadBalancer::failRequest(RequestTable::RequestID request_id, 
+                               const std::string& error_code)
+{
+    // The request may have been removed when its client is closed.
+    RequestInfo *request = request_table_.find(request_id);
+    if (request == nullptr)
+        return;
+
+    RequestInfo lost = *request;
+    finishRequest(request_id);
+
+    // A kept connection is closed by replyError() itself if the error
+    // response is its last one, so only other clients are closed here.
+    bool kept = client_conns_.find(lost.client_fd) != client_conns_.end();
+    replyError(lost.client_fd, error_code, lost.client_addr, lost.client_port, request_id);
+    if (!kept)
+        close(lost.client_fd);
+}
+
+//-------------------------------------------------------------------
+// Requests whose real servers do not answer in REQUEST_TIME_OUT 
+// seconds are answered by 504. The real server may still be working
+// on them, but its load is released, and a late response is dropped 
+// because its request ID is not found.
+//-------------------------------------------------------------------
+void LoadBalancer::handleRequestTimeout(const std::vector<uint64_t>& expired)
+{
+    for (auto id : expired)
+    {
+        RequestTable::RequestID request_id = static_cast<RequestTable::RequestID>(id);
+        RequestInfo *request = request_table_.find(request_id);
+        if (request == nullptr || request->client_fd == -1)
+            continue;
+
+        std::cout << "request " << request_id << " to real server " 
+                  << getServer(request->server_fd).address << " times out\n";
+        recordLatency(*request);
+        failRequest(request_id, StatusCode::ServerErrorStatusCode::HEAD504);
+    }
+
+    if (!expired.empty())
+        listRealServers();
+}
+
+//-------------------------------------------------------------------
+// Select the connection with least requests in flight in the pool of
+// a real server. A dropped connection has no request in flight. It is
+// selected only when every open connection is busy, and connected
+// again here.
+// return: -1 -- no connection is available
+//         otherwise -- fd of the connection
+//-------------------------------------------------------------------
+int LoadBalancer::selectConnection(int server_fd)
+{
+    PoolConnection *least_open = nullptr;
+    PoolConnection *dropped = nullptr;
+
+    for (auto& x : conn_pools_[server_fd])
+    {
+        if (x.fd == -1)
+        {
+            if (dropped == nullptr)
+                dropped = &x;
+        }
+        else if (least_open == nullptr || x.in_flight < least_open->in_flight)
+            least_open = &x;
+    }
+
+    if (dropped != nullptr && (least_open == nullptr || least_open->in_flight > 0))
+    {
+        if (openConnection(server_fd, *dropped) == SUCCESS)
+            return dropped->fd;
+    }
+
+    return (least_open == nullptr) ? -1 : least_open->fd;
+}
+
+//-------------------------------------------------------------------
+// Open a connection in the pool of a real server and start to read
+// responses from it.
+//-------------------------------------------------------------------
+Status LoadBalancer::openConnection(int server_fd, PoolConnection& conn)
+{
+    const RealServer& real_server = getServer(server_fd);
+    SocketCreator sc;
+    int fd = sc.inetConnect(real_server.address.c_str(), real_server.port_num.c_str(), SOCK_STREAM);
+    if (fd == -1)
+    {
+        std::cout << "cannot connect to real server " << real_server.address << std::endl;
+        return MINOR_ERROR;
+    }
+
+    if (uring_running_)
+    {
+        if (postRead(URING_SERVER_READ, fd, acquireBuffer(true)) == FATAL_ERROR)
+        {
+            close(fd);
+            return MINOR_ERROR;
         }
     }
+    else
+    {
+        addEvent(epoll_fd_, fd, OneShotType::NON_ONESHOT, BlockType::BLOCK);
+        server_buffers_[fd].setEvents(EPOLLIN);
+    }
+
+    conn_servers_[fd] = server_fd;
+    conn.fd = fd;
+    conn.in_flight = 0;
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Close a broken connection in a pool. Requests sent on it will never
+// be answered, so error responses are sent to their clients.
+//-------------------------------------------------------------------
+void LoadBalancer::dropConnection(int conn_fd)
+{
+    PoolConnection *conn = findConnection(conn_fd);
+    if (conn == nullptr)
+        return;
+
+    std::vector<RequestTable::RequestID> lost_requests;
+    request_table_.forEach([&](RequestTable::RequestID id, const RequestInfo& request)
+    {
+        if (request.conn_fd == conn_fd && request.client_fd != -1)
+            lost_requests.push_back(id);
+    });
+
+    for (auto id : lost_requests)
+        failRequest(id, StatusCode::ServerErrorStatusCode::HEAD502);
+
+    std::cout << "connection " << conn_fd << " to real server " 
+              << getServer(conn_servers_[conn_fd]).address << " drops\n";
+
+    conn->fd = -1;
+    conn->in_flight = 0;
+    conn_servers_.erase(conn_fd);
+    deleteEvent(epoll_fd_, conn_fd);
+    closeServerfd(conn_fd);
+}
+
+//-------------------------------------------------------------------
+// Find a connection in the pools by its fd.
+//-------------------------------------------------------------------
+PoolConnection* LoadBalancer::findConnection(int conn_fd)
+{
+    auto it = conn_servers_.find(conn_fd);
+    if (it == conn_servers_.end())
+        return nullptr;
+
+    for (auto& x : conn_pools_[it->second])
+    {
+        if (x.fd == conn_fd)
+            return &x;
+    }
+
+    return nullptr;
+}
+
+//-------------------------------------------------------------------
+// Close a connection to a real server. When io_uring engine is running,
+// the connection is only shut down here. The read waiting on it 
+// completes, and the fd is closed in handleUringCompletion().
+//-------------------------------------------------------------------
+void LoadBalancer::closeServerfd(int fd)
+{
+    server_buffers_.erase(fd);
+    shutdown(fd, SHUT_RDWR);
+    if (!uring_running_)
+        close(fd);
+}
+
+//-------------------------------------------------------------------
+// Accept a client in passthrough mode. Select a real server, open a
+// new connection to it and build a tunnel between the two sockets.
+// The request is not read here, and the tunnel forwards it as soon 
+// as the client socket is added to epoll fd.
+//-------------------------------------------------------------------
+Status LoadBalancer::acceptTunnel()
+{
+    socklen_t addrlen;
+    struct sockaddr_storage claddr;
+    int cfd;
+
+    addrlen = sizeof(struct sockaddr_storage);
+    cfd = accept(listen_fd_, (struct sockaddr*)&claddr, &addrlen);
+    if (cfd == -1)
+    {
+        ErrorHandler eh("accept", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return FATAL_ERROR;
+    }
+    std::cout << "Load balancer accepts client's fd: " << cfd << std::endl;
+
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    if (getSourceInfo((struct sockaddr*)&claddr, addrlen, host, service) == MINOR_ERROR)
+    {
+        close(cfd);
+        return MINOR_ERROR;
+    }
+
+    if (server_table_.count() <= 0)
+    {
+        fprintf(stderr, "No real server is available.\n");
+        close(cfd);
+        return Status::FATAL_ERROR;
+    }
+
+    syncServerLoad();
+    algorithm_selector_->setHandleIP(host);
+    int handle_fd = reserveServer();
+    if (handle_fd == -1 || handle_fd == 0)
+    {
+        std::cout << "cannot handle any requests" << std::endl;
+        replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD503, host, service);
+        close(cfd);
+        return Status::MINOR_ERROR;
+    }
+
+    // Connect to the real server. The connection to the real server 
+    // in server_table_ is kept for health check.
+    const RealServer& real_server = getServer(handle_fd);
+    SocketCreator sc;
+    int sfd = sc.inetConnect(real_server.address.c_str(), real_server.port_num.c_str(), SOCK_STREAM);
+    if (sfd == -1)
+    {
+        std::cout << "cannot connect to real server " << real_server.address << std::endl;
+        cancelReservation(handle_fd);
+        replyError(cfd, StatusCode::ServerErrorStatusCode::HEAD503, host, service);
+        close(cfd);
+        return Status::MINOR_ERROR;
+    }
+
+    Tunnel *tunnel = new Tunnel(cfd, sfd, server_table_.find(handle_fd));
+    if (tunnel->open() == -1)
+    {
+        cancelReservation(handle_fd);
+        delete tunnel;
+        return Status::MINOR_ERROR;
+    }
+
+    tunnel_map_[cfd] = tunnel;
+    tunnel_map_[sfd] = tunnel;
+    addEventMask(epoll_fd_, cfd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, NON_BLOCK);
+    addEventMask(epoll_fd_, sfd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, NON_BLOCK);
+
+    // A tunnel is counted as one request until it is closed, by the
+    // slot reserved for it.
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Move bytes of a tunnel when its client or real server is triggered.
+//-------------------------------------------------------------------
+Status LoadBalancer::handleTunnel(int trigger_fd)
+{
+    Tunnel *tunnel = tunnel_map_[trigger_fd];
+
+    int ret = tunnel->transfer();
+    if (ret == 1)
+        return Status::SUCCESS;
+
+    closeTunnel(tunnel);
+
+    return (ret == 0) ? Status::SUCCESS : Status::MINOR_ERROR;
+}
+
+//-------------------------------------------------------------------
+// Delete a tunnel and close its sockets.
+//-------------------------------------------------------------------
+void LoadBalancer::closeTunnel(Tunnel *tunnel)
+{
+    int client_fd = tunnel->getClientfd();
+    int server_fd = tunnel->getServerfd();
+
+    deleteEvent(epoll_fd_, client_fd);
+    deleteEvent(epoll_fd_, server_fd);
+    tunnel_map_.erase(client_fd);
+    tunnel_map_.erase(server_fd);
+
+    // If the real server has been removed, its load has been released
+    // in removeServer().
+    int index = tunnel->getServerIndex();
+    if (server_table_.inUse(index))
+        server_table_.setLoad(index, load_table_.decrement(worker_index_, index));
+
+    delete tunnel;
+}
+
+//-------------------------------------------------------------------
+// Create io_uring instance and register the buffers. Then post the
+// first operations: accept on listen fd, read on every real server,
+// timer fd and signal fd.
+//-------------------------------------------------------------------
+Status LoadBalancer::initUring()
+{
+    if (ring_.init(URING_ENTRIES) == -1)
+        return FATAL_ERROR;
+
+    uring_buffers_.resize(URING_BUFFERS * HTTPMessage::HTTP_MSG_SIZE);
+    if (ring_.registerBuffers(uring_buffers_.data(), URING_BUFFERS, 
+                              HTTPMessage::HTTP_MSG_SIZE) == -1)
+    {
+        ring_.destroy();
+        return FATAL_ERROR;
+    }
+
+    uring_payloads_.assign(URING_BUFFERS, std::string());
+    uring_done_.assign(URING_BUFFERS, 0);
+    free_buffers_.clear();
+    for (int i = URING_BUFFERS - 1; i >= 0; i--)
+        free_buffers_.push_back(i);
+
+    if (postAccept() == FATAL_ERROR ||
+        postRead(URING_TIMER, timer_fd_, -1) == FATAL_ERROR ||
+        postRead(URING_REQUEST_TIMER, request_timers_.getTimerfd(), -1) == FATAL_ERROR ||
+        postRead(URING_SIGNAL, signal_fd_, -1) == FATAL_ERROR)
+    {
+        ring_.destroy();
+        return FATAL_ERROR;
+    }
+
+    for (int i = 0; i < server_table_.size(); i++)
+    {
+        if (server_table_.inUse(i))
+            postRead(URING_SERVER_READ, server_table_.getFd(i), acquireBuffer(true));
+    }
+    for (auto& x : conn_servers_)
+        postRead(URING_SERVER_READ, x.first, acquireBuffer(true));
+
+    // A read of a probe timer stays in the ring until the timer expires.
+    for (auto& x : probe_timers_)
+        postRead(URING_PROBE_TIMER, x.first, -1);
+
+    std::cout << "Load balancer uses io_uring engine\n";
+    uring_running_ = true;
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Event loop based on io_uring. Operations prepared while handling
+// completions are submitted together in one io_uring_enter() call,
+// which also waits for the next completion.
+//-------------------------------------------------------------------
+void LoadBalancer::runUringLoop(struct itimerspec& ts)
+{
+    struct io_uring_cqe cqe;
+
+    while (balancer_run_)
+    {
+        if (ring_.submit(1) == -1)
+        {
+            balancer_run_ = false;
+            break;
+        }
+
+        while (balancer_run_ && ring_.peekCqe(cqe))
+            handleUringCompletion(cqe, ts);
+    }
+
+    ring_.destroy();
+    uring_requests_.clear();
+    uring_running_ = false;
+}
+
+//-------------------------------------------------------------------
+// Handle a completion. The operation, buffer index and fd are packed
+// in user_data of the completion.
+//-------------------------------------------------------------------
+void LoadBalancer::handleUringCompletion(const struct io_uring_cqe& cqe, struct itimerspec& ts)
+{
+    UringOp op = static_cast<UringOp>(cqe.user_data >> 56);
+    int index = (cqe.user_data >> 32) & 0xffff;
+    int fd = static_cast<int>(cqe.user_data & 0xffffffff);
+    int res = cqe.res;
+
+    DebugCode(printf("\top=%d; fd=%d; index=%d; res=%d\n", op, fd, index, res);)
+
+    switch (op)
+    {
+    case URING_ACCEPT:
+        // A multishot accept stops when there is an error.
+        if (!(cqe.flags & IORING_CQE_F_MORE) && postAccept() == FATAL_ERROR)
+        {
+            balancer_run_ = false;
+            break;
+        }
+        if (res < 0)
+        {
+            errno = -res;
+            ErrorHandler eh("accept", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+            break;
+        }
+
+        std::cout << "Load balancer accepts client's fd: " << res << std::endl;
+        index = acquireBuffer(false);
+        if (index == -1)
+        {
+            std::cout << "no buffer for client's fd: " << res << std::endl;
+            close(res);
+            break;
+        }
+        postRead(URING_CLIENT_READ, res, index);
+        break;
+
+    case URING_CLIENT_READ:
+        if (res <= 0)
+        {
+            if (res < 0)
+            {
+                errno = -res;
+                ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
+                eh.errMsg();
+            }
+            else
+                fprintf(stderr, "EOF of client\n");
+
+            uring_requests_.erase(fd);
+            close(fd);
+            releaseBuffer(index);
+            break;
+        }
+
+        // Read the rest of a message split by the network.
+        {
+            ConnBuffer& buffer = uring_requests_[fd];
+            buffer.append(uringBuffer(index), res);
+
+            HTTPMessage recv_msg;
+            if (!buffer.getMessage(recv_msg))
+            {
+                if (buffer.getReadState() == ConnBuffer::READ_ERROR ||
+                    postRead(URING_CLIENT_READ, fd, index) == FATAL_ERROR)
+                {
+                    uring_requests_.erase(fd);
+                    close(fd);
+                    releaseBuffer(index);
+                }
+                break;
+            }
+
+            // The client is closed after its response, so the bytes 
+            // behind the request are dropped.
+            uring_requests_.erase(fd);
+            if (handleUringRequest(fd, index, recv_msg) == FATAL_ERROR)
+                balancer_run_ = false;
+        }
+        break;
+
+    case URING_SERVER_WRITE:
+        if (res >= 0)
+        {
+            uring_done_[index] += res;
+            if (uring_done_[index] < uring_payloads_[index].size() &&
+                postWrite(URING_SERVER_WRITE, fd, index, false) == SUCCESS)
+                break;
+        }
+        if (res < 0 || uring_done_[index] < uring_payloads_[index].size())
+        {
+            errno = (res < 0) ? -res : EIO;
+            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+
+            // The request and other requests sent on the connection will
+            // never be handled.
+            dropConnection(fd);
+        }
+        releaseBuffer(index);
+        break;
+
+    case URING_SERVER_READ:
+    {
+        // The connection may have been shut down while it was read.
+        bool open = conn_servers_.find(fd) != conn_servers_.end() ||
+                    server_table_.find(fd) != -1;
+        if (res > 0 && open)
+        {
+            server_buffers_[fd].append(uringBuffer(index), res);
+            handleUringResponses(fd);
+
+            // A response may remove the real server.
+            open = conn_servers_.find(fd) != conn_servers_.end() ||
+                   server_table_.find(fd) != -1;
+            if (open && server_buffers_[fd].getReadState() != ConnBuffer::READ_ERROR)
+            {
+                if (postRead(URING_SERVER_READ, fd, index) == FATAL_ERROR)
+                    balancer_run_ = false;
+                break;
+            }
+        }
+
+        if (res < 0)
+        {
+            errno = -res;
+            ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+        }
+        else if (res == 0 && open)
+            fprintf(stderr, "unexpected EOF of a real server\n");
+
+        releaseBuffer(index);
+        if (open)
+            handleServerClosed(fd);
+
+        // This is the last read of the connection.
+        close(fd);
+        if (server_table_.count() <= 0)
+            balancer_run_ = false;
+        break;
+    }
+
+    case URING_CLIENT_WRITE:
+    case URING_HEALTH_WRITE:
+        // A short write is continued. For a client, the close linked to
+        // the write is cancelled, and it is linked to the new write.
+        if (res >= 0)
+        {
+            uring_done_[index] += res;
+            if (uring_done_[index] < uring_payloads_[index].size() &&
+                postWrite(op, fd, index, op == URING_CLIENT_WRITE) == SUCCESS)
+                break;
+        }
+        if (res < 0 || uring_done_[index] < uring_payloads_[index].size())
+        {
+            errno = (res < 0) ? -res : EIO;
+            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
+            eh.errMsg();
+
+            if (op == URING_CLIENT_WRITE)
+                close(fd);
+            else if (server_table_.find(fd) != -1)
+                removeServer(fd);
+        }
+        releaseBuffer(index);
+        break;
+
+    case URING_CLOSE:
+        // The close is linked to a write to a client. If the write is 
+        // short or fails, the close is cancelled, and the fd is closed
+        // when the write is finished.
+        break;
+
+    case URING_TIMER:
+        if (uringHealthCheck() == FATAL_ERROR)
+        {
+            std::cout << "fatal error from health check\n";
+            balancer_run_ = false;
+            break;
+        }
+
+        // reset the timer
+        timerfd_settime(timer_fd_, 0, &ts, NULL);
+        postRead(URING_TIMER, timer_fd_, -1);
+        break;
+
+    case URING_REQUEST_TIMER:
+        if (res == sizeof(request_expirations_))
+        {
+            std::vector<uint64_t> expired;
+            request_timers_.advance(request_expirations_, expired);
+            handleRequestTimeout(expired);
+        }
+        postRead(URING_REQUEST_TIMER, request_timers_.getTimerfd(), -1);
+        break;
+
+    case URING_PROBE_TIMER:
+        // The timer has been closed with its real server.
+        if (res < 0 || probe_timers_.find(fd) == probe_timers_.end())
+            break;
+
+        if (handleProbeTimeout(fd) == FATAL_ERROR)
+            balancer_run_ = false;
+        break;
+
+    case URING_SIGNAL:
+        if (res == sizeof(signal_info_) && 
+            (signal_info_.ssi_signo == SIGINT || signal_info_.ssi_signo == SIGTERM))
+        {
+            std::cout << "catch SIGINT\n";
+            balancer_run_ = false;
+            break;
+        }
+
+        if (res == sizeof(signal_info_) && signal_info_.ssi_signo == SIGHUP)
+            reloadConfig();
+        else
+            std::cout << "Unknown signal " << signal_info_.ssi_signo << std::endl;
+        postRead(URING_SIGNAL, signal_fd_, -1);
+        break;
+
+    default:
+        std::cout << "Unknown io_uring operation: " << op << std::endl;
+        break;
+    }
+}
+
+//-------------------------------------------------------------------
+// A request has been read from a client. Select a real server and
+// send the request from the buffer the client was read into.
+//-------------------------------------------------------------------
+Status LoadBalancer::handleUringRequest(int cfd, int index, HTTPMessage& recv_msg)
+{
+    struct sockaddr_storage claddr;
+    socklen_t addrlen = sizeof(struct sockaddr_storage);
+
+    // Multishot accept does not return client's address.
+    if (getpeername(cfd, (struct sockaddr*)&claddr, &addrlen) == -1)
+    {
+        ErrorHandler eh("getpeername", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        close(cfd);
+        releaseBuffer(index);
+        return MINOR_ERROR;
+    }
+
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    if (getSourceInfo((struct sockaddr*)&claddr, addrlen, host, service) == MINOR_ERROR)
+    {
+        close(cfd);
+        releaseBuffer(index);
+        return MINOR_ERROR;
+    }
+
+    // The io_uring engine closes a client after its response is sent,
+    // and "Connection" header is only removed.
+    getKeepAlive(recv_msg);
+
+    int conn_fd;
+    RequestTable::RequestID request_id;
+    Status ret = prepareRequest(cfd, host, service, recv_msg, conn_fd, request_id);
+    if (ret != SUCCESS)
+    {
+        close(cfd);
+        releaseBuffer(index);
+        return ret;
+    }
+
+    loadBuffer(index, recv_msg);
+    if (postWrite(URING_SERVER_WRITE, conn_fd, index, false) == FATAL_ERROR)
+    {
+        finishRequest(request_id);
+        close(cfd);
+        releaseBuffer(index);
+        return FATAL_ERROR;
+    }
+
+    listRealServers();
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Responses have been read from a real server. Send every complete 
+// response to its client from a free buffer, and close the client
+// after the write.
+//-------------------------------------------------------------------
+void LoadBalancer::handleUringResponses(int server_fd)
+{
+    HTTPMessage recv_msg;
+    while (true)
+    {
+        // The real server may be removed by a probe result.
+        auto it = server_buffers_.find(server_fd);
+        if (it == server_buffers_.end() || !it->second.getMessage(recv_msg))
+            break;
+
+        int target_fd = matchResponse(recv_msg);
+        if (target_fd == -1)
+            continue;
+
+        int index = acquireBuffer(true);
+        if (index == -1)
+        {
+            std::cout << "no buffer for client's fd: " << target_fd << std::endl;
+            close(target_fd);
+            continue;
+        }
+
+        loadBuffer(index, recv_msg);
+        if (postWrite(URING_CLIENT_WRITE, target_fd, index, true) == FATAL_ERROR)
+        {
+            close(target_fd);
+            releaseBuffer(index);
+        }
+    }
+}
+
+//-------------------------------------------------------------------
+// Send probes to real servers from registered buffers. Same as 
+// healthCheck(), the results are handled as they come back.
+//-------------------------------------------------------------------
+Status LoadBalancer::uringHealthCheck()
+{
+    std::cout << "======== Begin Health Check ========\n";
+
+    HTTPMessage check_msg;
+    for (int i = 0; i < server_table_.size(); i++)
+    {
+        int server_fd = server_table_.getFd(i);
+        if (!server_table_.inUse(i) || prepareProbe(server_fd, check_msg) != SUCCESS)
+            continue;
+
+        int index = acquireBuffer(true);
+        if (index == -1)
+            return Status::MINOR_ERROR;
+        loadBuffer(index, check_msg);
+
+        if (postWrite(URING_HEALTH_WRITE, server_fd, index, false) == FATAL_ERROR)
+            return Status::FATAL_ERROR;
+    }
+
+    // All real servers are not available.
+    if (server_table_.count() <= 0)
+    {
+        std::cout << "No real server is available.\n";
+        return Status::FATAL_ERROR;
+    }
+
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Post a multishot accept on listen fd.
+//-------------------------------------------------------------------
+Status LoadBalancer::postAccept()
+{
+    struct io_uring_sqe *sqe = ring_.getSqe();
+    if (sqe == nullptr)
+    {
+        std::cout << "io_uring submission queue is full\n";
+        return FATAL_ERROR;
+    }
+
+    IoUring::prepAcceptMultishot(sqe, listen_fd_, packUserData(URING_ACCEPT, -1, listen_fd_));
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Post a read. A client or a real server is read into a registered
+// buffer, while timer fd and signal fd are read into data members.
+// The bytes read are moved into the ConnBuffer of the connection, so
+// every read fills the buffer from its first byte.
+//-------------------------------------------------------------------
+Status LoadBalancer::postRead(UringOp op, int fd, int index)
+{
+    if ((op == URING_CLIENT_READ || op == URING_SERVER_READ) && index == -1)
+    {
+        std::cout << "no buffer to read fd: " << fd << std::endl;
+        return FATAL_ERROR;
+    }
+
+    struct io_uring_sqe *sqe = ring_.getSqe();
+    if (sqe == nullptr)
+    {
+        std::cout << "io_uring submission queue is full\n";
+        return FATAL_ERROR;
+    }
+
+    uint64_t user_data = packUserData(op, index, fd);
+    switch (op)
+    {
+    case URING_TIMER:
+        IoUring::prepRead(sqe, fd, &timer_expirations_, sizeof(timer_expirations_), user_data);
+        break;
+    case URING_REQUEST_TIMER:
+        IoUring::prepRead(sqe, fd, &request_expirations_, sizeof(request_expirations_), user_data);
+        break;
+    case URING_PROBE_TIMER:
+        IoUring::prepRead(sqe, fd, &probe_expirations_, sizeof(probe_expirations_), user_data);
+        break;
+    case URING_SIGNAL:
+        IoUring::prepRead(sqe, fd, &signal_info_, sizeof(signal_info_), user_data);
+        break;
+    default:
+        IoUring::prepReadFixed(sqe, fd, uringBuffer(index), HTTPMessage::HTTP_MSG_SIZE, 
+                               index, user_data);
+        break;
+    }
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Post a write of the payload of a buffer, from its first byte not 
+// sent. A payload which fits in the registered buffer is written from
+// there, and a longer one is written from the payload itself.
+// If close_after is true, a close of fd is linked to the write.
+//-------------------------------------------------------------------
+Status LoadBalancer::postWrite(UringOp op, int fd, int index, bool close_after)
+{
+    struct io_uring_sqe *sqe = ring_.getSqe();
+    if (sqe == nullptr)
+    {
+        std::cout << "io_uring submission queue is full\n";
+        return FATAL_ERROR;
+    }
+
+    const std::string& payload = uring_payloads_[index];
+    unsigned done = uring_done_[index];
+    if (payload.size() <= HTTPMessage::HTTP_MSG_SIZE)
+        IoUring::prepWriteFixed(sqe, fd, uringBuffer(index) + done, payload.size() - done,
+                                index, packUserData(op, index, fd));
+    else
+        IoUring::prepWrite(sqe, fd, payload.data() + done, payload.size() - done,
+                           packUserData(op, index, fd));
+    if (!close_after)
+        return SUCCESS;
+
+    sqe->flags |= IOSQE_IO_LINK;
+    sqe = ring_.getSqe();
+    if (sqe == nullptr)
+    {
+        std::cout << "io_uring submission queue is full\n";
+        return FATAL_ERROR;
+    }
+    IoUring::prepClose(sqe, fd, packUserData(URING_CLOSE, -1, fd));
+
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Get a free registered buffer. Buffers for clients leave one buffer
+// per connection to real servers, so that a response read from every
+// connection can be sent.
+// return: -1 -- no buffer is available
+//         otherwise -- index of the buffer
+//-------------------------------------------------------------------
+int LoadBalancer::acquireBuffer(bool reserved)
+{
+    size_t limit = reserved ? 0 : server_table_.count() + conn_servers_.size();
+    if (free_buffers_.size() <= limit)
+        return -1;
+
+    int index = free_buffers_.back();
+    free_buffers_.pop_back();
+    uring_payloads_[index].clear();
+    uring_done_[index] = 0;
+
+    return index;
+}
+
+//-------------------------------------------------------------------
+// Take a message as the payload of a buffer to be written. The 
+// message is left empty.
+//-------------------------------------------------------------------
+void LoadBalancer::loadBuffer(int index, HTTPMessage& msg)
+{
+    std::string& payload = uring_payloads_[index];
+    payload.swap(msg.http_msg);
+    msg.http_msg.clear();
+    if (payload.size() <= HTTPMessage::HTTP_MSG_SIZE)
+        memcpy(uringBuffer(index), payload.data(), payload.size());
+    uring_done_[index] = 0;
+}
+
+//-------------------------------------------------------------------
+// Return the first byte of a registered buffer
+//-------------------------------------------------------------------
+char* LoadBalancer::uringBuffer(int index)
+{
+    return &uring_buffers_[index * HTTPMessage::HTTP_MSG_SIZE];
+}
+
+//-------------------------------------------------------------------
+// Put a registered buffer back.
+//-------------------------------------------------------------------
+void LoadBalancer::releaseBuffer(int index)
+{
+    free_buffers_.push_back(index);
+}
+
+//-------------------------------------------------------------------
+// Pack an operation, a buffer index and an fd into user_data of an
+// SQE, which is returned in the CQE.
+//-------------------------------------------------------------------
+uint64_t LoadBalancer::packUserData(UringOp op, int index, int fd)
+{
+    return (static_cast<uint64_t>(op) << 56) | 
+           (static_cast<uint64_t>(index & 0xffff) << 32) | 
+           static_cast<uint32_t>(fd);
+}
+
+//-------------------------------------------------------------------
+// Check health of every real server in the server_table_. A probe is
+// sent to every real server, and this function returns without
+// waiting for the results. They are handled in handleProbeResult()
+// when the responses come back, or in handleProbeTimeout() when the
+// probe timers expire.
+//-------------------------------------------------------------------
+Status LoadBalancer::healthCheck()
+{
+    std::cout << "======== Begin Health Check ========\n";
+
+    HTTPMessage check_msg;
+    int server_fd;
+
+    // Send an HTTP message with method of OPTIONS to real servers.
+    // A removed server leaves its slot, so the loop is not disturbed.
+    for (int i = 0; i < server_table_.size(); i++)
+    {
+        server_fd = server_table_.getFd(i);
+        if (!server_table_.inUse(i) || prepareProbe(server_fd, check_msg) != SUCCESS)
+            continue;
+
+        if (sendToServer(server_fd, check_msg) != SUCCESS)
+            removeServer(server_fd);
+    }
 
-    // When target_fd = 0, it means that either request_map_ is empty, 
-    // or there's no same target_port element. A child of a real server
-    // terminates can usually cause this happen. Under this situation, 
-    // no response needed to be returned.
-    if (target_fd == 0)
+    // All real servers are not available.
+    if (server_table_.count() <= 0) 
     {
-        std::cout << "A child of a real server terminates.\n";
-        return Status::MINOR_ERROR;
+        std::cout << "No real server is available.\n";
+        return Status::FATAL_ERROR;
     }
 
-    std::cout << "target port is " << target_port_ << "\n target client_fd = " << target_fd << std::endl;
+    return Status::SUCCESS;
+}
 
-    if (write(target_fd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
+//-------------------------------------------------------------------
+// Create the probe timer of a real server. The timer is armed only
+// when a probe is waiting for its response.
+//-------------------------------------------------------------------
+Status LoadBalancer::addProbe(int server_fd)
+{
+    int probe_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (probe_timer_fd == -1)
     {
-        ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
+        ErrorHandler eh("timerfd_create", __FILE__, __FUNCTION__, __LINE__);
         eh.errMsg();
-        return Status::MINOR_ERROR;
+        return MINOR_ERROR;
     }
 
-    if (close(target_fd) == -1)
-    {
-        ErrorHandler eh("close", __FILE__, __FUNCTION__, __LINE__);
-        eh.errMsg();
-        return Status::MINOR_ERROR;
-    }
+    HealthProbe probe = { probe_timer_fd, RequestTable::INVALID_ID };
+    probes_[server_fd] = probe;
+    probe_timers_[probe_timer_fd] = server_fd;
+    addEvent(epoll_fd_, probe_timer_fd, OneShotType::NON_ONESHOT, BlockType::BLOCK);
 
-    // Because a real server has just finished a request, decrement
-    // current load by 1.
-    server_pool_[trigger_fd].cur_load -= 1;
+    return SUCCESS;
+}
 
-    listRealServers();
+//-------------------------------------------------------------------
+// Delete the probe of a real server and close its timer.
+//-------------------------------------------------------------------
+void LoadBalancer::removeProbe(int server_fd)
+{
+    auto it = probes_.find(server_fd);
+    if (it == probes_.end())
+        return;
 
-    return Status::SUCCESS;
+    if (it->second.request_id != RequestTable::INVALID_ID)
+        request_table_.erase(it->second.request_id);
+
+    deleteEvent(epoll_fd_, it->second.timer_fd);
+    close(it->second.timer_fd);
+    probe_timers_.erase(it->second.timer_fd);
+    probes_.erase(it);
 }
 
 //-------------------------------------------------------------------
-// Check health of every real server on the server_pool_
+// Construct a probe for a real server and arm its timer. The probe is
+// put into request table with client_fd of -1, so that its response 
+// is matched by request ID like other responses. The message is sent
+// by the caller.
+// return: MINOR_ERROR -- the last probe is still waiting, or the probe
+//                        cannot be sent now
+//         SUCCESS -- the probe is ready
 //-------------------------------------------------------------------
-Status LoadBalancer::healthCheck()
+Status LoadBalancer::prepareProbe(int server_fd, HTTPMessage& check_msg)
 {
-    std::cout << "======== Begin Health Check ========\n";
-    //sleep(1); 
-    
-    // If real servers are still handling requests, there is no need
-    // to check health. Only check health when the servers are free.
-    if (request_map_.size() > 0)
-        return Status::MINOR_ERROR;
+    auto it = probes_.find(server_fd);
+    if (it == probes_.end())
+        return MINOR_ERROR;
 
-    // If using Weighted Least Connection scheduling algorithm (default), 
-    // when there is a server that is free, there is no possibility
-    // that a server is handling two requests. Sleep to wait all requests
-    // are finished and begin health check.
-    else if (request_map_.size() <= server_pool_.size())
-        sleep(3);
+    // The timer of the last probe decides whether the server is dead.
+    HealthProbe& probe = it->second;
+    if (probe.request_id != RequestTable::INVALID_ID)
+        return MINOR_ERROR;
 
-    HTTPMessage check_msg;
-    HTTPMessage recv_msg;
-    int server_fd;
-    ServerPool::iterator it = server_pool_.begin();
+    const RealServer& real_server = getServer(server_fd);
+    OptionsMethodWriter hmw("*", "HTTP/1.1", real_server.address, "*", BIND_ADDRESS, PORT_NUM);
+    hmw.constructHTTPMsg(check_msg);
 
-    // Send an HTTP message with method of OPTIONS to real servers.
-    while (it != server_pool_.end())
+    RequestInfo request;
+    snprintf(request.client_addr, sizeof(request.client_addr), "%s", BIND_ADDRESS);
+    snprintf(request.client_port, sizeof(request.client_port), "%s", PORT_NUM);
+    request.client_fd = -1;
+    request.server_fd = server_fd;
+    request.conn_fd = server_fd;
+    request.send_time = getMonotonicTime();
+
+    RequestTable::RequestID request_id = request_table_.insert(request);
+    if (request_id == RequestTable::INVALID_ID)
+        return MINOR_ERROR;
+
+    char id_header[32];
+    snprintf(id_header, sizeof(id_header), "Request-ID: %u", request_id);
+    if (HTTPWriter::insertHeader(check_msg, id_header) == -1)
     {
-        OptionsMethodWriter hmw("*", "HTTP/1.1", it->second.address, "*", BIND_ADDRESS, PORT_NUM);
-        hmw.constructHTTPMsg(check_msg);
+        request_table_.erase(request_id);
+        return MINOR_ERROR;
+    }
 
-        std::cout << "check message:\n";
-        std::cout << check_msg.http_msg;
+    struct itimerspec ts;
+    ts.it_interval.tv_sec = 0;
+    ts.it_interval.tv_nsec = 0;
+    ts.it_value.tv_sec = HEALTH_CHECK_TIME_OUT;
+    ts.it_value.tv_nsec = 0;
+    if (timerfd_settime(probe.timer_fd, 0, &ts, NULL) == -1)
+    {
+        ErrorHandler eh("timerfd_settime", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        request_table_.erase(request_id);
+        return MINOR_ERROR;
+    }
+    probe.request_id = request_id;
 
-        server_fd = it->first;
-        if (write(server_fd, check_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
-        {
-            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
-            eh.errMsg();
+    std::cout << "check message:\n";
+    std::cout << check_msg.http_msg;
 
-            deleteEvent(epoll_fd_, server_fd);
-            FD_CLR(server_fd, &server_fds_);
-            close(server_fd);
-            it = server_pool_.erase(it);
-            continue;
-        }
+    return SUCCESS;
+}
 
-        memset(recv_msg.http_msg, '\0', HTTPMessage::HTTP_MSG_SIZE);
-        size_t numRead = read(server_fd, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-        if (numRead == -1 || numRead == 0) 
-        {
-            if (numRead == -1) 
-            {
-                ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
-                eh.errMsg();
-            }
-            else 
-                fprintf(stderr, "unexpected EOF from server\n");
+//-------------------------------------------------------------------
+// A real server answers its probe in time. Stop the probe timer and
+// remove the probe from request table. Any response, even 503 from a
+// busy server, shows that the server is alive.
+//-------------------------------------------------------------------
+void LoadBalancer::handleProbeResult(int server_fd, RequestTable::RequestID request_id,
+                                     const HTTPMessage& recv_msg)
+{
+    request_table_.erase(request_id);
 
-            deleteEvent(epoll_fd_, server_fd);
-            FD_CLR(server_fd, &server_fds_);
-            close(server_fd);
-            it = server_pool_.erase(it);
-            continue;
-        }
+    auto it = probes_.find(server_fd);
+    if (it == probes_.end() || it->second.request_id != request_id)
+        return;
 
-        std::cout << "Health Check Result:\n";
-        std::cout << recv_msg.http_msg;
+    struct itimerspec ts;
+    memset(&ts, 0, sizeof(ts));
+    timerfd_settime(it->second.timer_fd, 0, &ts, NULL);
+    it->second.request_id = RequestTable::INVALID_ID;
 
-        it++;
-    }
+    std::cout << "Health Check Result:\n";
+    std::cout << recv_msg.http_msg;
+}
+
+//-------------------------------------------------------------------
+// The probe timer of a real server expires before the response comes
+// back. The server is regarded as dead and removed from server_table_.
+//-------------------------------------------------------------------
+Status LoadBalancer::handleProbeTimeout(int timer_fd)
+{
+    int server_fd = probe_timers_[timer_fd];
+    std::cout << "Health check of server " << getServer(server_fd).address 
+              << " times out\n";
+
+    removeServer(server_fd);
 
     // All real servers are not available.
-    if (server_pool_.size() <= 0) 
+    if (server_table_.count() <= 0) 
     {
         std::cout << "No real server is available.\n";
         return Status::FATAL_ERROR;
     }
 
-    return Status::SUCCESS;
+    return Status::MINOR_ERROR;
 }
 
 //-------------------------------------------------------------------
@@ -675,6 +2322,9 @@ Status LoadBalancer::handleSignal()
         clearAll();
         exit(EXIT_SUCCESS);
         break;
+    case SIGHUP:
+        reloadConfig();
+        break;
     default:
         std::cout << "Unknown signal " << receive_signal << std::endl;
         break;
@@ -684,11 +2334,363 @@ Status LoadBalancer::handleSignal()
 }
 
 //-------------------------------------------------------------------
-// Reset server_pool_
+// Get a real server by the fd of its control connection. The server
+// must be in server_table_.
+//-------------------------------------------------------------------
+const RealServer& LoadBalancer::getServer(int server_fd) const
+{
+    return server_table_.get(server_table_.find(server_fd));
+}
+
+//-------------------------------------------------------------------
+// Read the configuration file given by -f. Every line is one of:
+//     algorithm <name>              scheduling algorithm, e.g. WLC
+//     weight <address> <max load>   max load of a real server
+//     bound <epsilon>               the same as -e
+//     expire <seconds>              the same as -x
+// The arguments hold the current values, and are changed only by the
+// lines in the file. If the file has an error, MINOR_ERROR is returned
+// and nothing should be changed.
+//-------------------------------------------------------------------
+Status LoadBalancer::readConfig(SchedAlgorithm& sched_type, double& epsilon, int& expire_time,
+                                std::vector<std::pair<std::string, int>>& weights)
+{
+    if (config_.config_file == nullptr)
+    {
+        std::cout << "No configuration file to reload, it is given by -f\n";
+        return Status::MINOR_ERROR;
+    }
+
+    std::ifstream in(config_.config_file);
+    if (!in)
+    {
+        fprintf(stderr, "Cannot open configuration file %s\n", config_.config_file);
+        return Status::MINOR_ERROR;
+    }
+
+    std::string line;
+    int line_num = 0;
+    while (std::getline(in, line))
+    {
+        line_num++;
+        std::istringstream fields(line);
+        std::string key, value;
+        if (!(fields >> key) || key[0] == '#')
+            continue;
+
+        bool correct = false;
+        if (key == "algorithm")
+            correct = (fields >> value) && getSchedAlgorithm(value, sched_type);
+        else if (key == "weight")
+        {
+            int max_load = 0;
+            correct = (fields >> value >> max_load) && max_load > 0;
+            if (correct)
+                weights.push_back({ value, max_load });
+        }
+        else if (key == "bound")
+            correct = static_cast<bool>(fields >> epsilon);
+        else if (key == "expire")
+            correct = (fields >> expire_time) && expire_time >= 0;
+
+        if (!correct)
+        {
+            fprintf(stderr, "Incorrect line %d in %s, configuration is not changed\n",
+                    line_num, config_.config_file);
+            return Status::MINOR_ERROR;
+        }
+    }
+
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Read the configuration file again, when a worker catches SIGHUP.
+// The whole file is read before anything is changed, so a file with
+// an error changes nothing. The new max loads are set first, then a
+// new scheduling algorithm is built from server_table_ and replaces
+// the old one between two events. The event loop goes on, and every
+// request is scheduled by either the old or the new algorithm. Loads
+// stay in server_table_ and load_table_, so requests in flight are
+// counted by the new algorithm and finished as before.
+//-------------------------------------------------------------------
+Status LoadBalancer::reloadConfig()
+{
+    SchedAlgorithm sched_type = algorithm_selector_->getSchedType();
+    double epsilon = config_.hash_load_bound;
+    int expire_time = config_.expire_time;
+    std::vector<std::pair<std::string, int>> weights;
+
+    if (readConfig(sched_type, epsilon, expire_time, weights) != Status::SUCCESS)
+        return Status::MINOR_ERROR;
+
+    for (const auto& x : weights)
+    {
+        bool found = false;
+        for (int i = 0; i < server_table_.size(); i++)
+        {
+            if (!server_table_.inUse(i) || server_table_.get(i).address != x.first)
+                continue;
+
+            server_table_.setMaxLoad(i, x.second);
+            load_table_.setMaxLoad(i, x.second);
+            found = true;
+        }
+
+        if (!found)
+            std::cout << "real server " << x.first << " is not connected\n";
+    }
+
+    config_.hash_load_bound = epsilon;
+    config_.expire_time = expire_time;
+    algorithm_selector_->setLoadBound(epsilon);
+    algorithm_selector_->setExpireTime(expire_time);
+    algorithm_selector_->setSchedType(sched_type);
+
+    std::cout << "Configuration is reloaded from " << config_.config_file << std::endl;
+    listRealServers();
+
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Read the configuration file again, when the master catches SIGHUP.
+// The master keeps the scheduling algorithm, -e and -x, so that a
+// worker forked again later starts with them. Max loads are kept in 
+// load_table_ by the workers.
+//-------------------------------------------------------------------
+Status LoadBalancer::reloadMasterConfig()
+{
+    SchedAlgorithm sched_type = algorithm_selector_->getSchedType();
+    double epsilon = config_.hash_load_bound;
+    int expire_time = config_.expire_time;
+    std::vector<std::pair<std::string, int>> weights;
+
+    if (readConfig(sched_type, epsilon, expire_time, weights) != Status::SUCCESS)
+        return Status::MINOR_ERROR;
+
+    config_.hash_load_bound = epsilon;
+    config_.expire_time = expire_time;
+    algorithm_selector_->setLoadBound(epsilon);
+    algorithm_selector_->setExpireTime(expire_time);
+    algorithm_selector_->setSchedType(sched_type);
+
+    return Status::SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Copy current loads and response times in the shared load table into
+// server_table_, so that scheduling algorithms see requests sent by
+// all the workers. A real server which another worker has found down
+// is removed. With one worker, every change is made by this worker
+// and already in server_table_, so there is nothing to copy.
+// Only the servers in the logs of the other workers are copied. Every
+// server is copied at the first call, or if changes have been missed.
+// Every LATENCY_DECAY_INTERVAL, response times are decayed, so that a
+// real server which got no requests after a slow response is tried
+// again before the next health check.
+//-------------------------------------------------------------------
+void LoadBalancer::syncServerLoad()
+{
+    if (config_.worker_count > 1)
+    {
+        changed_servers_.clear();
+        if (load_table_.getChanges(worker_index_, change_cursors_, changed_servers_))
+        {
+            for (auto x : changed_servers_)
+                syncServer(x);
+        }
+        else
+        {
+            for (int i = 0; i < server_table_.size(); i++)
+                syncServer(i);
+        }
+    }
+
+    uint64_t now = getMonotonicTime();
+    if (now - latency_decay_time_ >= ServerTable::LATENCY_DECAY_INTERVAL)
+    {
+        server_table_.decayLatency(now);
+        latency_decay_time_ = now;
+    }
+}
+
+//-------------------------------------------------------------------
+// Copy the shared state of one real server into server_table_
+//-------------------------------------------------------------------
+void LoadBalancer::syncServer(int index)
+{
+    if (!server_table_.inUse(index))
+        return;
+
+    if (!load_table_.isHealthy(index))
+    {
+        std::cout << "real server " << server_table_.get(index).address
+                  << " is down in another worker" << std::endl;
+        removeServer(server_table_.getFd(index));
+        return;
+    }
+
+    server_table_.setLoad(index, load_table_.getLoad(index));
+
+    double latency;
+    uint64_t latency_time;
+    load_table_.getLatency(index, latency, latency_time);
+    // The response time in server_table_ is newer if it has been
+    // decayed since the last sample.
+    if (latency_time > server_table_.get(index).latency_time)
+        server_table_.setLatency(index, latency, latency_time);
+}
+
+//-------------------------------------------------------------------
+// Delete resources of a real server which meets an error. Requests
+// this worker has sent to the server get error responses, and they
+// are taken out of the load table.
+//-------------------------------------------------------------------
+void LoadBalancer::removeServer(int server_fd)
+{
+    for (auto& x : conn_pools_[server_fd])
+    {
+        if (x.fd != -1)
+            dropConnection(x.fd);
+    }
+    conn_pools_.erase(server_fd);
+
+    deleteEvent(epoll_fd_, server_fd);
+    removeProbe(server_fd);
+    int index = server_table_.find(server_fd);
+    load_table_.releaseServer(worker_index_, index);
+    load_table_.setHealthy(worker_index_, index, false);
+    server_table_.remove(index);
+    closeServerfd(server_fd);
+}
+
+//-------------------------------------------------------------------
+// Send an error response to a client, such as 503 when no real server
+// can handle the request. For a kept client connection, the response
+// takes the place of the request's response, which is request_id or
+// the request being prepared.
+//-------------------------------------------------------------------
+void LoadBalancer::replyError(int client_fd, const std::string& error_code,
+                              const char *host, const char *service,
+                              RequestTable::RequestID request_id)
+{
+    HTTPMessage send_msg;
+    ResponseMessage rm("HTTP/1.1", error_code, host, service);
+    rm.constructHTTPMsg(send_msg);
+
+    if (client_conns_.find(client_fd) != client_conns_.end())
+        completeResponse(client_fd, request_id, send_msg);
+    else
+        ConnBuffer::writeFull(client_fd, send_msg.http_msg.data(), send_msg.http_msg.size());
+}
+
+//-------------------------------------------------------------------
+// The response of a request from a kept client connection is ready.
+// Send it, and the responses behind it, if the responses before it
+// have been sent.
+//-------------------------------------------------------------------
+void LoadBalancer::completeResponse(int client_fd, RequestTable::RequestID request_id,
+                                    const HTTPMessage& response)
+{
+    auto it = client_conns_.find(client_fd);
+    if (it == client_conns_.end())
+        return;
+
+    for (auto& x : it->second.responses)
+    {
+        if (!x.ready && x.request_id == request_id)
+        {
+            x.response = response;
+            x.ready = true;
+            break;
+        }
+    }
+
+    flushClient(client_fd);
+}
+
+//-------------------------------------------------------------------
+// Send the ready responses at the head of a client connection. When
+// all the responses have been sent, the connection is either closed,
+// or becomes idle and waits for the next request. A response the 
+// client cannot take now is sent when EPOLLOUT is reported.
+//-------------------------------------------------------------------
+void LoadBalancer::flushClient(int client_fd)
+{
+    ClientConnection& client = client_conns_[client_fd];
+
+    while (!client.responses.empty() && client.responses.front().ready)
+    {
+        PendingResponse& pending = client.responses.front();
+        bool keep_alive = pending.keep_alive;
+        if (keep_alive)
+            HTTPWriter::insertHeader(pending.response, "Connection: keep-alive");
+
+        client.buffer.queueMessage(pending.response);
+        client.responses.pop_front();
+
+        // This is the last response of the connection.
+        if (!keep_alive)
+            break;
+    }
+
+    int ret = client.buffer.flushTo(client_fd);
+    if (ret == -1)
+    {
+        closeClient(client_fd);
+        return;
+    }
+
+    if (ret == 0 && client.responses.empty())
+    {
+        if (client.closing)
+        {
+            closeClient(client_fd);
+            return;
+        }
+        idle_timers_.start(client_fd);
+    }
+
+    watchOutput(client_fd, client.buffer, !client.closing);
+}
+
+//-------------------------------------------------------------------
+// Close a client connection. Its requests still being handled are
+// removed from request table, so that their responses are dropped
+// instead of being sent to a new client with the same fd.
+//-------------------------------------------------------------------
+void LoadBalancer::closeClient(int client_fd)
+{
+    auto it = client_conns_.find(client_fd);
+    if (it == client_conns_.end())
+        return;
+
+    for (auto& x : it->second.responses)
+    {
+        if (!x.ready)
+            finishRequest(x.request_id);
+    }
+
+    deleteEvent(epoll_fd_, client_fd);
+    idle_timers_.stop(client_fd);
+    close(client_fd);
+    client_conns_.erase(it);
+}
+
+//-------------------------------------------------------------------
+// Close the client connections which have been idle too long.
 //-------------------------------------------------------------------
-void LoadBalancer::setServerPool(const ServerPool& server_pool) 
-{ 
-    server_pool_ = server_pool; 
+void LoadBalancer::handleIdleTimeout()
+{
+    std::vector<int> expired_fds;
+    idle_timers_.getExpired(expired_fds);
+
+    for (auto fd : expired_fds)
+    {
+        std::cout << "client connection " << fd << " is idle, close it\n";
+        closeClient(fd);
+    }
 }
 
 //-------------------------------------------------------------------
@@ -720,13 +2722,34 @@ Status LoadBalancer::getSourceInfo(struct sockaddr* addr,
 void LoadBalancer::clearAll()
 {
     std::cout << "Load Balancer shuts down...\n";
+
+    // Every tunnel is in tunnel_map_ twice.
+    while (tunnel_map_.size() > 0)
+        closeTunnel(tunnel_map_.begin()->second);
+
+    while (client_conns_.size() > 0)
+        closeClient(client_conns_.begin()->first);
+
     close(epoll_fd_);
 
-    for (auto x : server_pool_)
+    for (int i = 0; i < server_table_.size(); i++)
+    {
+        if (server_table_.inUse(i))
+            close(server_table_.getFd(i));
+    }
+
+    for (auto x : conn_servers_)
         close(x.first);
 
-    for (auto x : request_map_)
-        close(x.second.client_fd);
+    for (auto x : probes_)
+        close(x.second.timer_fd);
+
+    // Probes of health check have no client.
+    request_table_.forEach([](RequestTable::RequestID, const RequestInfo& request)
+    {
+        if (request.client_fd != -1)
+            close(request.client_fd);
+    });
 
     close(timer_fd_);
     close(signal_fd_);
@@ -747,12 +2770,18 @@ void LoadBalancer::clearAll()
 void LoadBalancer::listRealServers()
 {
     std::cout << std::left << std::setw(12) << "Server" << std::setw(8)
-        << "Port" << std::setw(10) << "Max Load" << std::setw(18) << "Current Load" << std::endl;
+        << "Port" << std::setw(10) << "Max Load" << std::setw(14) << "Current Load"
+        << std::setw(14) << "Latency (us)" << std::endl;
 
-    for (auto it : server_pool_)
+    for (int i = 0; i < server_table_.size(); i++)
     {
-        std::cout << std::left << std::setw(12) << it.first << std::setw(8) << it.second.port_num
-            << std::setw(10) << it.second.max_load << std::setw(18) << it.second.cur_load << std::endl;
+        if (!server_table_.inUse(i))
+            continue;
+
+        const RealServer& server = server_table_.get(i);
+        std::cout << std::left << std::setw(12) << server_table_.getFd(i) << std::setw(8) << server.port_num
+            << std::setw(10) << server.max_load << std::setw(14) << server.cur_load
+            << std::setw(14) << static_cast<long>(server.latency) << std::endl;
     }
 }
 
@@ -761,43 +2790,87 @@ void LoadBalancer::listRealServers()
 //-------------------------------------------------------------------
 void LoadBalancer::listRequests()
 {
-    std::cout << std::left << std::setw(8) << "Port" << std::setw(12)
-        << "Address" << std::setw(10) << "Client fd" << std::endl;
+    std::cout << std::left << std::setw(12) << "Request ID" << std::setw(8) << "Port" 
+        << std::setw(12) << "Address" << std::setw(10) << "Client fd" 
+        << std::setw(10) << "Server fd" << std::setw(10) << "Conn fd" << std::endl;
 
-    for (auto it : request_map_)
+    request_table_.forEach([](RequestTable::RequestID id, const RequestInfo& request)
     {
-        std::cout << std::left << std::setw(8) << it.first << std::setw(12)
-            << it.second.client_addr << std::setw(10) << it.second.client_fd << std::endl;
-    }
+        std::cout << std::left << std::setw(12) << id << std::setw(8) << request.client_port 
+            << std::setw(12) << request.client_addr << std::setw(10) << request.client_fd 
+            << std::setw(10) << request.server_fd << std::setw(10) << request.conn_fd << std::endl;
+    });
 }
 
 
 
 int main(int argc, char* argv[])
 {
-    if (argc < 2)
+    BalancerConfig config = { 1, false, false, 1, -1.0, 0, nullptr };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:puc:e:x:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            config.pool_size = atoi(optarg);
+            break;
+        case 'e':
+            config.hash_load_bound = atof(optarg);
+            break;
+        case 'x':
+            config.expire_time = atoi(optarg);
+            break;
+        case 'f':
+            config.config_file = optarg;
+            break;
+        case 'u':
+            config.io_uring = true;
+            break;
+        case 'p':
+            config.passthrough = true;
+            break;
+        case 'w':
+            // 0 means one worker per online core
+            config.worker_count = atoi(optarg);
+            if (config.worker_count == 0)
+                config.worker_count = sysconf(_SC_NPROCESSORS_ONLN);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (optind >= argc)
     {
-        std::cout << "Usage: " << argv[0] << " <scheduling algorithm>\n";
+        std::cout << "Usage: " << argv[0] << " [-w <#workers>] [-p] [-u] [-c <#connections>] [-e <epsilon>] [-x <seconds>] [-f <file>] <scheduling algorithm>\n";
+        std::cout << "-w:  number of workers, 0 means one per core (default 1)\n";
+        std::cout << "-p:  TCP passthrough mode, forward bytes without parsing\n";
+        std::cout << "-u:  use io_uring engine instead of epoll\n";
+        std::cout << "-c:  number of connections to every real server (default 1)\n";
+        std::cout << "-e:  DH and SH keep every server under (1 + epsilon) times the average load\n";
+        std::cout << "-x:  LBLC forgets the server of a URL not requested for this time (default 86400)\n";
+        std::cout << "-f:  configuration file read again on SIGHUP (algorithm, weight, bound, expire)\n";
         std::cout << "RR:  Round Robin\n";
         std::cout << "WRR: Weighted Round Robin\n";
         std::cout << "LC:  Least Connection\n";
         std::cout << "WLC: Weighted Least Connection (Recommended)\n";
         std::cout << "DH:  Destination Hashing\n";
         std::cout << "SH:  Source Hashing\n";
+        std::cout << "P2C: Power of Two Choices\n";
+        std::cout << "MH:  Maglev Hashing\n";
+        std::cout << "PEWMA: Peak EWMA of response time\n";
+        std::cout << "SED: Shortest Expected Delay\n";
+        std::cout << "NQ:  Never Queue\n";
+        std::cout << "LBLC: Locality-Based Least Connection\n";
         exit(EXIT_SUCCESS);
     }
 
-    std::unordered_map<std::string, SchedAlgorithm> algorithm_map;
-    algorithm_map.insert({ "RR", Round_Robin });
-    algorithm_map.insert({ "WRR", Weighted_Round_Robin });
-    algorithm_map.insert({ "LC", Least_Connection });
-    algorithm_map.insert({ "WLC", Weighted_Least_Connection });
-    algorithm_map.insert({ "DH", Destination_Hashing });
-    algorithm_map.insert({ "SH", Source_Hashing });
-
-    if (algorithm_map.find(argv[1]) != algorithm_map.end())
+    SchedAlgorithm sched_type;
+    if (getSchedAlgorithm(argv[optind], sched_type))
     {
-        LoadBalancer *lb = LoadBalancer::create(algorithm_map.at(argv[1]));
+        LoadBalancer *lb = LoadBalancer::create(sched_type, config);
         lb->start();
     }
     else
@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////
+//  RequestTable.cpp - implementation of RequestTable class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/LoadBalancer/RequestTable.h"
+
+const RequestTable::RequestID RequestTable::INVALID_ID;
+const uint32_t RequestTable::MAX_REQUESTS;
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+RequestTable::RequestTable()
+    : free_head_(0), size_(0)
+{}
+
+//-------------------------------------------------------------------
+// Put a request into a free slot. If there is no free slot, append a
+// new one. The generation of a slot starts from 1 and skips 0 when it
+// wraps around, so a request ID is never INVALID_ID.
+//-------------------------------------------------------------------
+RequestTable::RequestID RequestTable::insert(const RequestInfo& request)
+{
+    uint32_t index;
+
+    if (free_head_ < slots_.size())
+    {
+        index = free_head_;
+        free_head_ = slots_[index].next_free;
+    }
+    else if (slots_.size() < MAX_REQUESTS)
+    {
+        index = slots_.size();
+        Slot slot;
+        slot.generation = 0;
+        slots_.push_back(slot);
+        free_head_ = slots_.size();
+    }
+    else
+        return INVALID_ID;
+
+    Slot& slot = slots_[index];
+    if (++slot.generation == 0)
+        slot.generation = 1;
+    slot.in_use = true;
+    slot.request = request;
+    size_++;
+
+    return (static_cast<RequestID>(slot.generation) << 16) | index;
+}
+
+//-------------------------------------------------------------------
+// Find a request by its ID.
+//-------------------------------------------------------------------
+RequestInfo* RequestTable::find(RequestID id)
+{
+    uint32_t index = getIndex(id);
+    if (index >= slots_.size())
+        return nullptr;
+
+    Slot& slot = slots_[index];
+    if (!slot.in_use || slot.generation != getGeneration(id))
+        return nullptr;
+
+    return &slot.request;
+}
+
+//-------------------------------------------------------------------
+// Remove a request and put its slot back to the free list.
+// return: false -- there is no such request
+//         true  -- success
+//-------------------------------------------------------------------
+bool RequestTable::erase(RequestID id)
+{
+    if (find(id) == nullptr)
+        return false;
+
+    uint32_t index = getIndex(id);
+    slots_[index].in_use = false;
+    slots_[index].next_free = free_head_;
+    free_head_ = index;
+    size_--;
+
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Invoke visitor on every request in the table.
+//-------------------------------------------------------------------
+void RequestTable::forEach(const Visitor& visitor) const
+{
+    for (uint32_t i = 0; i < slots_.size(); i++)
+    {
+        if (slots_[i].in_use)
+            visitor((static_cast<RequestID>(slots_[i].generation) << 16) | i, slots_[i].request);
+    }
+}
+
+//-------------------------------------------------------------------
+// Return the number of requests in the table.
+//-------------------------------------------------------------------
+size_t RequestTable::size() const
+{
+    return size_;
+}
@@ -0,0 +1,321 @@
+/////////////////////////////////////////////////////////////////////
+//  SharedLoadTable.cpp - implementation of shared load counters
+//  ver 1.0                                                        
+//  Language:      standard C++ 11                                
+//  Platform:      Ubuntu 14.04, 32-bit                               
+//  Application:   2014 Summer Project                            
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include <string.h>
+#include "../../include/LoadBalancer/SharedLoadTable.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+SharedLoadTable::SharedLoadTable()
+    : servers_(nullptr), worker_loads_(nullptr), logs_(nullptr), row_size_(0),
+      server_count_(0), worker_count_(0), map_size_(0)
+{}
+
+//-------------------------------------------------------------------
+// Destructor
+// The mapping is not released here, because a forked worker holds
+// a copy of this object. Use destroy() to release it.
+//-------------------------------------------------------------------
+SharedLoadTable::~SharedLoadTable()
+{}
+
+//-------------------------------------------------------------------
+// Map an anonymous shared region which holds the states of
+// server_count servers, followed by worker_count rows of worker
+// counters and worker_count logs of changes. Every row is padded to
+// whole cache lines. The mapping
+// starts at a page, so every state is in its own cache line. The
+// region is inherited by children created by fork() afterwards.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int SharedLoadTable::create(int server_count, int worker_count)
+{
+    int per_line = CACHE_LINE_SIZE / sizeof(std::atomic<int>);
+    row_size_ = (server_count + per_line - 1) / per_line * per_line;
+    map_size_ = server_count * sizeof(ServerState) +
+                row_size_ * worker_count * sizeof(std::atomic<int>) +
+                worker_count * sizeof(ChangeLog);
+
+    void *addr = mmap(NULL, map_size_, PROT_READ | PROT_WRITE, 
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        ErrorHandler eh("mmap", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    servers_ = static_cast<ServerState*>(addr);
+    worker_loads_ = reinterpret_cast<std::atomic<int>*>(servers_ + server_count);
+    logs_ = reinterpret_cast<ChangeLog*>(worker_loads_ + row_size_ * worker_count);
+    server_count_ = server_count;
+    worker_count_ = worker_count;
+
+    for (int i = 0; i < server_count; i++)
+    {
+        ServerState *state = new (&servers_[i]) ServerState;
+        state->load.store(0);
+        state->max_load.store(0);
+        state->healthy.store(0);
+        state->latency.store(0);
+        state->latency_time.store(0);
+    }
+    for (int i = 0; i < row_size_ * worker_count; i++)
+        new (&worker_loads_[i]) std::atomic<int>(0);
+    for (int i = 0; i < worker_count; i++)
+    {
+        ChangeLog *log = new (&logs_[i]) ChangeLog;
+        log->head.store(0);
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Unmap the shared region
+//-------------------------------------------------------------------
+void SharedLoadTable::destroy()
+{
+    if (servers_ == nullptr)
+        return;
+
+    munmap(servers_, map_size_);
+    servers_ = nullptr;
+    worker_loads_ = nullptr;
+    logs_ = nullptr;
+}
+
+//-------------------------------------------------------------------
+// A worker has connected to a real server and got its max load. Every
+// worker connects to the same servers, so the first one sets the max
+// load. A worker forked again after the max load is changed by
+// reloading configuration takes the changed one, instead of writing
+// the max load reported by the real server back.
+//-------------------------------------------------------------------
+int SharedLoadTable::setServer(int index, int max_load)
+{
+    int current = 0;
+    servers_[index].max_load.compare_exchange_strong(current, max_load);
+    servers_[index].healthy.store(1);
+    return (current == 0) ? max_load : current;
+}
+
+//-------------------------------------------------------------------
+// Get current load of a real server
+//-------------------------------------------------------------------
+int SharedLoadTable::getLoad(int index) const
+{
+    return servers_[index].load.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------
+// Get max load of a real server
+//-------------------------------------------------------------------
+int SharedLoadTable::getMaxLoad(int index) const
+{
+    return servers_[index].max_load.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------
+// Change max load of a real server. Slots already reserved are kept,
+// a lower max load only stops new reservations.
+//-------------------------------------------------------------------
+void SharedLoadTable::setMaxLoad(int index, int max_load)
+{
+    servers_[index].max_load.store(max_load);
+}
+
+//-------------------------------------------------------------------
+// Whether a real server is up
+//-------------------------------------------------------------------
+bool SharedLoadTable::isHealthy(int index) const
+{
+    return servers_[index].healthy.load() != 0;
+}
+
+//-------------------------------------------------------------------
+// Mark a real server up or down for all the workers
+//-------------------------------------------------------------------
+void SharedLoadTable::setHealthy(int worker, int index, bool healthy)
+{
+    servers_[index].healthy.store(healthy ? 1 : 0);
+    logChange(worker, index);
+}
+
+//-------------------------------------------------------------------
+// A worker is going to send a request to a real server. The load is
+// only increased if it stays within the limit when the swap is made,
+// so the limit holds however many workers reserve at the same time.
+//-------------------------------------------------------------------
+int SharedLoadTable::reserve(int worker, int index, int reserved)
+{
+    ServerState& state = servers_[index];
+    if (!isHealthy(index))
+        return -1;
+
+    int limit = state.max_load.load(std::memory_order_relaxed) - reserved;
+    int load = state.load.load(std::memory_order_relaxed);
+    do
+    {
+        if (load + 1 > limit)
+            return -1;
+    } while (!state.load.compare_exchange_weak(load, load + 1));
+
+    workerLoad(worker, index).fetch_add(1, std::memory_order_relaxed);
+    logChange(worker, index);
+    return load + 1;
+}
+
+//-------------------------------------------------------------------
+// A worker has sent a request to a real server without a reservation
+//-------------------------------------------------------------------
+int SharedLoadTable::increment(int worker, int index)
+{
+    workerLoad(worker, index).fetch_add(1, std::memory_order_relaxed);
+    int load = servers_[index].load.fetch_add(1) + 1;
+    logChange(worker, index);
+    return load;
+}
+
+//-------------------------------------------------------------------
+// A real server has finished a request of a worker
+//-------------------------------------------------------------------
+int SharedLoadTable::decrement(int worker, int index)
+{
+    workerLoad(worker, index).fetch_sub(1, std::memory_order_relaxed);
+    int load = servers_[index].load.fetch_sub(1) - 1;
+    logChange(worker, index);
+    return load;
+}
+
+//-------------------------------------------------------------------
+// Peak EWMA of response time, as in ServerTable. The average and its
+// time are two words, so a sample added by another worker at the same
+// time may be lost. That only drops a sample of an average.
+//-------------------------------------------------------------------
+double SharedLoadTable::addLatency(int worker, int index, uint64_t rtt, uint64_t now)
+{
+    ServerState& state = servers_[index];
+
+    double latency;
+    uint64_t latency_time;
+    getLatency(index, latency, latency_time);
+    latency = ServerTable::peakEWMA(latency, latency_time, rtt, now);
+
+    uint64_t bits;
+    memcpy(&bits, &latency, sizeof(bits));
+    state.latency.store(bits, std::memory_order_relaxed);
+    state.latency_time.store((now == 0) ? 1 : now, std::memory_order_release);
+    logChange(worker, index);
+    return latency;
+}
+
+//-------------------------------------------------------------------
+// Get the shared response time of a real server and the time of its
+// last sample, which is 0 if there is none.
+//-------------------------------------------------------------------
+void SharedLoadTable::getLatency(int index, double& latency, uint64_t& latency_time) const
+{
+    const ServerState& state = servers_[index];
+    latency_time = state.latency_time.load(std::memory_order_acquire);
+    uint64_t bits = state.latency.load(std::memory_order_relaxed);
+    memcpy(&latency, &bits, sizeof(latency));
+}
+
+//-------------------------------------------------------------------
+// A worker loses its connection to a real server, so the requests it
+// sent on that connection will never be finished.
+//-------------------------------------------------------------------
+void SharedLoadTable::releaseServer(int worker, int index)
+{
+    int count = workerLoad(worker, index).exchange(0);
+    if (count != 0)
+    {
+        servers_[index].load.fetch_sub(count);
+        logChange(worker, index);
+    }
+}
+
+//-------------------------------------------------------------------
+// A worker terminates, take all its requests out of the counters.
+// This is invoked by the master after the worker has been reaped.
+//-------------------------------------------------------------------
+void SharedLoadTable::releaseWorker(int worker)
+{
+    for (int i = 0; i < server_count_; i++)
+        releaseServer(worker, i);
+}
+
+//-------------------------------------------------------------------
+// Read the logs of the other workers from the cursors up to their
+// heads. If a writer has gone a whole ring past a cursor, before or
+// while its entries are read, they cannot be trusted, and false is
+// returned. At the first call, the cursors start at the heads.
+//-------------------------------------------------------------------
+bool SharedLoadTable::getChanges(int worker, std::vector<uint64_t>& cursors,
+                                 std::vector<int>& indexes) const
+{
+    if (cursors.size() != static_cast<size_t>(worker_count_))
+    {
+        cursors.resize(worker_count_);
+        for (int i = 0; i < worker_count_; i++)
+            cursors[i] = logs_[i].head.load(std::memory_order_acquire);
+        return false;
+    }
+
+    bool complete = true;
+    for (int i = 0; i < worker_count_; i++)
+    {
+        if (i == worker)
+            continue;
+
+        const ChangeLog& log = logs_[i];
+        uint64_t cursor = cursors[i];
+        uint64_t head = log.head.load(std::memory_order_acquire);
+        if (head - cursor < LOG_SIZE)
+        {
+            for (uint64_t n = cursor; n < head; n++)
+                indexes.push_back(log.entries[n % LOG_SIZE].load(std::memory_order_relaxed));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (log.head.load(std::memory_order_relaxed) - cursor >= LOG_SIZE)
+                complete = false;
+        }
+        else
+            complete = false;
+
+        cursors[i] = head;
+    }
+
+    return complete;
+}
+
+//-------------------------------------------------------------------
+// A worker has changed the state of a real server. Only the worker
+// writes its log, so the entry is written before the head is moved.
+//-------------------------------------------------------------------
+void SharedLoadTable::logChange(int worker, int index)
+{
+    ChangeLog& log = logs_[worker];
+    uint64_t head = log.head.load(std::memory_order_relaxed);
+    log.entries[head % LOG_SIZE].store(index, std::memory_order_relaxed);
+    log.head.store(head + 1, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------
+// Counter of requests a worker has sent to a real server
+//-------------------------------------------------------------------
+std::atomic<int>& SharedLoadTable::workerLoad(int worker, int index)
+{
+    return worker_loads_[worker * row_size_ + index];
+}
@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////
+//  TimerList.cpp - implementation of TimerList class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/LoadBalancer/TimerList.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+TimerList::TimerList()
+    : timer_fd_(-1), time_out_(0)
+{}
+
+//-------------------------------------------------------------------
+// Destructor
+//-------------------------------------------------------------------
+TimerList::~TimerList()
+{
+    if (timer_fd_ != -1)
+        close(timer_fd_);
+}
+
+//-------------------------------------------------------------------
+// Create the timer fd. It is not armed until a timer is started.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int TimerList::init(time_t time_out)
+{
+    time_out_ = time_out;
+
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ == -1)
+    {
+        ErrorHandler eh("timerfd_create", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Return the timer fd
+//-------------------------------------------------------------------
+int TimerList::getTimerfd() const
+{
+    return timer_fd_;
+}
+
+//-------------------------------------------------------------------
+// Start the timer of fd, or restart it if it is running. The timer fd
+// only needs to be armed when the list is empty before. Otherwise it
+// is armed for the head, which expires earlier.
+//-------------------------------------------------------------------
+void TimerList::start(int fd)
+{
+    stop(fd);
+
+    Timer timer;
+    timer.fd = fd;
+    clock_gettime(CLOCK_MONOTONIC, &timer.deadline);
+    timer.deadline.tv_sec += time_out_;
+
+    timers_.push_back(timer);
+    timer_index_[fd] = --timers_.end();
+
+    if (timers_.size() == 1)
+        arm();
+}
+
+//-------------------------------------------------------------------
+// Stop the timer of fd. If it is the head, the timer fd expires early
+// and getExpired() arms it again for the new head.
+//-------------------------------------------------------------------
+void TimerList::stop(int fd)
+{
+    auto it = timer_index_.find(fd);
+    if (it == timer_index_.end())
+        return;
+
+    timers_.erase(it->second);
+    timer_index_.erase(it);
+}
+
+//-------------------------------------------------------------------
+// Take all the expired timers out of the list.
+//-------------------------------------------------------------------
+void TimerList::getExpired(std::vector<int>& expired_fds)
+{
+    uint64_t expirations;
+    read(timer_fd_, &expirations, sizeof(expirations));
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    while (!timers_.empty())
+    {
+        const Timer& head = timers_.front();
+        if (head.deadline.tv_sec > now.tv_sec ||
+            (head.deadline.tv_sec == now.tv_sec && head.deadline.tv_nsec > now.tv_nsec))
+            break;
+
+        expired_fds.push_back(head.fd);
+        timer_index_.erase(head.fd);
+        timers_.pop_front();
+    }
+
+    arm();
+}
+
+//-------------------------------------------------------------------
+// Arm the timer fd with the deadline of the head, or disarm it if
+// there is no timer.
+//-------------------------------------------------------------------
+void TimerList::arm()
+{
+    struct itimerspec ts;
+    memset(&ts, 0, sizeof(ts));
+    if (!timers_.empty())
+        ts.it_value = timers_.front().deadline;
+
+    if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &ts, NULL) == -1)
+    {
+        ErrorHandler eh("timerfd_settime", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+    }
+}
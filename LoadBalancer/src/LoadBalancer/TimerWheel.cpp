@@ -0,0 +1,240 @@
+/////////////////////////////////////////////////////////////////////
+//  TimerWheel.cpp - implementation of TimerWheel class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/LoadBalancer/TimerWheel.h"
+
+const uint32_t TimerWheel::NIL;
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+TimerWheel::TimerWheel()
+    : heads_(LEVELS * SLOTS, NIL), current_(0), size_(0), armed_(false),
+      timer_fd_(-1), tick_ms_(1)
+{}
+
+//-------------------------------------------------------------------
+// Destructor
+//-------------------------------------------------------------------
+TimerWheel::~TimerWheel()
+{
+    if (timer_fd_ != -1)
+        close(timer_fd_);
+}
+
+//-------------------------------------------------------------------
+// Create the timer fd. It does not tick until a timer is started.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int TimerWheel::init(unsigned tick_ms)
+{
+    tick_ms_ = (tick_ms > 0) ? tick_ms : 1;
+
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ == -1)
+    {
+        ErrorHandler eh("timerfd_create", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Return the timer fd
+//-------------------------------------------------------------------
+int TimerWheel::getTimerfd() const
+{
+    return timer_fd_;
+}
+
+//-------------------------------------------------------------------
+// Start the timer of key, or restart it if it is running. The next
+// tick comes in less than one tick, so one more tick is added to make
+// sure that the timer does not expire early.
+//-------------------------------------------------------------------
+void TimerWheel::start(uint32_t key, uint64_t data, unsigned time_out_ms)
+{
+    if (key >= timers_.size())
+    {
+        Timer idle = { 0, 0, NIL, NIL, NIL };
+        timers_.resize(key + 1, idle);
+    }
+    else
+        stop(key);
+
+    Timer& timer = timers_[key];
+    timer.expire = current_ + (time_out_ms + tick_ms_ - 1) / tick_ms_;
+    timer.data = data;
+    link(key);
+    size_++;
+
+    if (!armed_)
+        arm(true);
+}
+
+//-------------------------------------------------------------------
+// Stop the timer of key. The timer fd keeps ticking until the next
+// getExpired() finds the wheel empty, so stopping the last timer costs
+// no system call.
+//-------------------------------------------------------------------
+void TimerWheel::stop(uint32_t key)
+{
+    if (key >= timers_.size() || timers_[key].slot == NIL)
+        return;
+
+    unlink(key);
+    size_--;
+}
+
+//-------------------------------------------------------------------
+// Return number of running timers
+//-------------------------------------------------------------------
+size_t TimerWheel::size() const
+{
+    return size_;
+}
+
+//-------------------------------------------------------------------
+// Read the number of ticks passed from the timer fd, and run them.
+//-------------------------------------------------------------------
+void TimerWheel::getExpired(std::vector<uint64_t>& expired)
+{
+    uint64_t ticks;
+    if (read(timer_fd_, &ticks, sizeof(ticks)) != sizeof(ticks))
+        ticks = 0;
+
+    advance(ticks, expired);
+}
+
+//-------------------------------------------------------------------
+// Run ticks one by one. When level 0 wraps around, the current slot of
+// level 1 is cascaded, and so on up the levels. Then the timers in the
+// current slot of level 0 expire. Ticks left when the wheel becomes
+// empty need not be run, and the timer fd is disarmed.
+//-------------------------------------------------------------------
+void TimerWheel::advance(uint64_t ticks, std::vector<uint64_t>& expired)
+{
+    for (uint64_t i = 0; i < ticks && size_ > 0; i++)
+    {
+        uint32_t index = current_ & (SLOTS - 1);
+        for (unsigned level = 1; index == 0 && level < LEVELS; level++)
+        {
+            index = (current_ >> (level * LEVEL_BITS)) & (SLOTS - 1);
+            cascade(level);
+        }
+
+        uint32_t& head = heads_[current_ & (SLOTS - 1)];
+        while (head != NIL)
+        {
+            uint32_t key = head;
+            expired.push_back(timers_[key].data);
+            unlink(key);
+            size_--;
+        }
+
+        current_++;
+    }
+
+    if (size_ == 0 && armed_)
+        arm(false);
+}
+
+//-------------------------------------------------------------------
+// Put a timer into the lowest level whose range covers its deadline.
+// A deadline beyond the top level is cut to the last tick the wheel
+// can hold.
+//-------------------------------------------------------------------
+void TimerWheel::link(uint32_t key)
+{
+    Timer& timer = timers_[key];
+    if (timer.expire < current_)
+        timer.expire = current_;
+
+    uint64_t delta = timer.expire - current_;
+    const uint64_t max_delta = (static_cast<uint64_t>(1) << (LEVELS * LEVEL_BITS)) - 1;
+    if (delta > max_delta)
+    {
+        delta = max_delta;
+        timer.expire = current_ + max_delta;
+    }
+
+    unsigned level = 0;
+    while (level < LEVELS - 1 && delta >= (static_cast<uint64_t>(1) << ((level + 1) * LEVEL_BITS)))
+        level++;
+
+    uint32_t slot = level * SLOTS + ((timer.expire >> (level * LEVEL_BITS)) & (SLOTS - 1));
+    timer.slot = slot;
+    timer.prev = NIL;
+    timer.next = heads_[slot];
+    if (timer.next != NIL)
+        timers_[timer.next].prev = key;
+    heads_[slot] = key;
+}
+
+//-------------------------------------------------------------------
+// Take a timer out of its slot
+//-------------------------------------------------------------------
+void TimerWheel::unlink(uint32_t key)
+{
+    Timer& timer = timers_[key];
+
+    if (timer.prev != NIL)
+        timers_[timer.prev].next = timer.next;
+    else
+        heads_[timer.slot] = timer.next;
+    if (timer.next != NIL)
+        timers_[timer.next].prev = timer.prev;
+
+    timer.prev = timer.next = timer.slot = NIL;
+}
+
+//-------------------------------------------------------------------
+// Move the timers in the current slot of a level to lower levels.
+//-------------------------------------------------------------------
+void TimerWheel::cascade(unsigned level)
+{
+    uint32_t slot = level * SLOTS + ((current_ >> (level * LEVEL_BITS)) & (SLOTS - 1));
+    uint32_t key = heads_[slot];
+    heads_[slot] = NIL;
+
+    while (key != NIL)
+    {
+        uint32_t next = timers_[key].next;
+        link(key);
+        key = next;
+    }
+}
+
+//-------------------------------------------------------------------
+// Start the timer fd ticking periodically, or stop it.
+//-------------------------------------------------------------------
+void TimerWheel::arm(bool on)
+{
+    struct itimerspec ts;
+    memset(&ts, 0, sizeof(ts));
+    if (on)
+    {
+        ts.it_interval.tv_sec = tick_ms_ / 1000;
+        ts.it_interval.tv_nsec = (tick_ms_ % 1000) * 1000000L;
+        ts.it_value = ts.it_interval;
+    }
+
+    if (timerfd_settime(timer_fd_, 0, &ts, NULL) == -1)
+    {
+        ErrorHandler eh("timerfd_settime", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return;
+    }
+
+    armed_ = on;
+}
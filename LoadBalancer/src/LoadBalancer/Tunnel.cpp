@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////
+//  Tunnel.cpp - implementation of Tunnel class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/LoadBalancer/Tunnel.h"
+#include "../../include/Common/ErrorHandler.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+Tunnel::Tunnel(int client_fd, int server_fd, int server_index)
+    : server_index_(server_index)
+{
+    upstream_ = { client_fd, server_fd, { -1, -1 }, 0, false, false };
+    downstream_ = { server_fd, client_fd, { -1, -1 }, 0, false, false };
+}
+
+//-------------------------------------------------------------------
+// Destructor
+// Close both sockets and pipes. Bytes left in the pipes are dropped.
+//-------------------------------------------------------------------
+Tunnel::~Tunnel()
+{
+    close(upstream_.from_fd);
+    close(upstream_.to_fd);
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (upstream_.pipe_fd[i] != -1)
+            close(upstream_.pipe_fd[i]);
+        if (downstream_.pipe_fd[i] != -1)
+            close(downstream_.pipe_fd[i]);
+    }
+}
+
+//-------------------------------------------------------------------
+// Create a pipe for each direction.
+// return: -1 -- occur an error
+//          0 -- success
+//-------------------------------------------------------------------
+int Tunnel::open()
+{
+    if (pipe2(upstream_.pipe_fd, O_NONBLOCK | O_CLOEXEC) == -1 ||
+        pipe2(downstream_.pipe_fd, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+        ErrorHandler eh("pipe2", __FILE__, __FUNCTION__, __LINE__);
+        eh.errMsg();
+        return -1;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Move bytes in both directions. The tunnel is finished when the real
+// server closes its connection and the response has been sent to the
+// client. When the client closes first, the write end of the server
+// socket is shut down, and the server will close its connection.
+//-------------------------------------------------------------------
+int Tunnel::transfer()
+{
+    if (transferOneWay(upstream_) == -1 || transferOneWay(downstream_) == -1)
+        return -1;
+
+    if (downstream_.eof && downstream_.pending == 0)
+        return 0;
+
+    return 1;
+}
+
+//-------------------------------------------------------------------
+// Move bytes from from_fd to the pipe, and from the pipe to to_fd,
+// until from_fd has no more data or to_fd cannot be written. Because
+// the sockets are edge triggered, the loop must not stop before one
+// of them returns EAGAIN.
+//-------------------------------------------------------------------
+int Tunnel::transferOneWay(Direction& direction)
+{
+    bool progress = true;
+
+    while (progress)
+    {
+        progress = false;
+
+        if (!direction.eof && direction.pending < SPLICE_SIZE)
+        {
+            ssize_t num_in = splice(direction.from_fd, NULL, direction.pipe_fd[1], NULL,
+                                    SPLICE_SIZE - direction.pending,
+                                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (num_in > 0)
+            {
+                direction.pending += num_in;
+                progress = true;
+            }
+            else if (num_in == 0)
+                direction.eof = true;
+            else if (errno != EAGAIN)
+            {
+                ErrorHandler eh("splice", __FILE__, __FUNCTION__, __LINE__);
+                eh.errMsg();
+                return -1;
+            }
+        }
+
+        while (direction.pending > 0)
+        {
+            ssize_t num_out = splice(direction.pipe_fd[0], NULL, direction.to_fd, NULL,
+                                     direction.pending,
+                                     SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (num_out > 0)
+            {
+                direction.pending -= num_out;
+                progress = true;
+            }
+            else if (num_out == -1 && errno == EAGAIN)
+                break; // wait for EPOLLOUT of to_fd
+            else
+            {
+                ErrorHandler eh("splice", __FILE__, __FUNCTION__, __LINE__);
+                eh.errMsg();
+                return -1;
+            }
+        }
+    }
+
+    // Pass the end of stream to the other side.
+    if (direction.eof && direction.pending == 0 && !direction.shutdown)
+    {
+        shutdown(direction.to_fd, SHUT_WR);
+        direction.shutdown = true;
+    }
+
+    return 0;
+}
+
+//-------------------------------------------------------------------
+// Return the client socket
+//-------------------------------------------------------------------
+int Tunnel::getClientfd() const
+{
+    return upstream_.from_fd;
+}
+
+//-------------------------------------------------------------------
+// Return the socket connected to the real server
+//-------------------------------------------------------------------
+int Tunnel::getServerfd() const
+{
+    return upstream_.to_fd;
+}
+
+//-------------------------------------------------------------------
+// Return index of the real server in load table
+//-------------------------------------------------------------------
+int Tunnel::getServerIndex() const
+{
+    return server_index_;
+}
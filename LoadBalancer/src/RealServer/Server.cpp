@@ -33,11 +33,9 @@ Server::Server(int max_children, const char *host)
     children_free_ = 0;
 
     listen_fd_ = 0;
-    client_fd_ = 0;
     epoll_fd_ = 0;
     signal_fd_ = 0;
     timer_fd_ = 0;
-    FD_ZERO(&timer_fds_);
     server_stop_ = false;
 
     ts_.it_interval.tv_sec = 0;
@@ -56,7 +54,6 @@ Server::~Server()
     children_free_ = 0;
 
     listen_fd_ = 0;
-    client_fd_ = 0;
     epoll_fd_ = 0;
     signal_fd_ = 0;
     timer_fd_ = 0;
@@ -86,7 +83,8 @@ Status Server::initEpollfd()
 
 //-------------------------------------------------------------------
 // Bind and listen to an IP address and port number, produce a listen
-// fd.
+// fd. The listen fd is monitored by epoll, because every worker of a
+// load balancer opens its own connection to the server.
 //-------------------------------------------------------------------
 Status Server::initListenfd()
 {
@@ -101,31 +99,36 @@ Status Server::initListenfd()
         return FATAL_ERROR;
     }
 
+    addEvent(epoll_fd_, listen_fd_, NON_ONESHOT, BLOCK);
+
     return SUCCESS;
 }
 
 //-------------------------------------------------------------------
-// Accept the first request sent by load balancer. The request should
-// be an HTTP message with SERVERCHECK method. Then the server could
-// only handle requests from this only one laod balancer.
+// Accept a connection from the load balancer. The first request sent
+// on the control connection of a load balancer should be an HTTP message
+// with SERVERCHECK method, while the connections in its pool only carry
+// requests.
 //-------------------------------------------------------------------
-Status Server::initClientfd()
+Status Server::acceptClient()
 {
     socklen_t addrlen;
     struct sockaddr_storage claddr;
 
     addrlen = sizeof(struct sockaddr_storage);
-    client_fd_ = accept(listen_fd_, (struct sockaddr*)&claddr, &addrlen);
-    if (client_fd_ == -1)
+    int cfd = accept(listen_fd_, (struct sockaddr*)&claddr, &addrlen);
+    if (cfd == -1)
     {
         ErrorHandler eh("accept", __FILE__, __FUNCTION__, __LINE__);
         eh.errMsg();
-        close(epoll_fd_);
-        close(listen_fd_);
         return FATAL_ERROR;
     }
 
-    addEvent(epoll_fd_, client_fd_, NON_ONESHOT, BLOCK);
+    std::cout << "Server accepts load balancer's fd: " << cfd << std::endl;
+
+    addEventMask(epoll_fd_, cfd, EPOLLIN, NON_BLOCK);
+    conn_buffers_[cfd] = ConnBuffer();
+    conn_buffers_[cfd].setEvents(EPOLLIN);
 
     return SUCCESS;
 }
@@ -170,8 +173,7 @@ Status Server::initSignalfd()
 void Server::start()
 {
     if (initEpollfd() == FATAL_ERROR ||
-        initListenfd() == FATAL_ERROR ||
-        initClientfd() == FATAL_ERROR)
+        initListenfd() == FATAL_ERROR)
         return;
 
     for (int index = 0; index < PREFORKED_CHILDREN; index++)
@@ -223,10 +225,26 @@ void Server::start()
 
             trigger_fd = evlist[i].data.fd;
 
-            // handle requests from a client (load balancer)
-            if ((trigger_fd == client_fd_) & evlist[i].events & EPOLLIN)
+            // accept a new connection from the load balancer
+            if ((trigger_fd == listen_fd_) & evlist[i].events & EPOLLIN)
+            {
+                if (acceptClient() == FATAL_ERROR)
+                {
+                    server_stop_ = true;
+                    break;
+                }
+            }
+
+            // handle requests from a client (load balancer), or send the
+            // responses left in its buffer
+            else if (conn_buffers_.find(trigger_fd) != conn_buffers_.end())
             { 
-                if (handleRequestFromClient() == FATAL_ERROR)
+                if (evlist[i].events & EPOLLOUT)
+                    flushClient(trigger_fd);
+
+                if (conn_buffers_.find(trigger_fd) != conn_buffers_.end() && 
+                    (evlist[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) &&
+                    handleRequestFromClient(trigger_fd) == FATAL_ERROR)
                 {
                     server_stop_ = true;
                     break;
@@ -234,7 +252,7 @@ void Server::start()
             }
 
             // handle timers' alarm
-            else if ((FD_ISSET(trigger_fd, &timer_fds_)) & evlist[i].events & EPOLLIN) 
+            else if ((timer_fds_.find(trigger_fd) != timer_fds_.end()) & evlist[i].events & EPOLLIN) 
             {
                 if (handleChildTimeOut(trigger_fd) == FATAL_ERROR)
                 {
@@ -285,33 +303,55 @@ void Server::start()
 }
 
 //-------------------------------------------------------------------
-// Handle requests from a client (load balancer). 
-// The server first reads and gets the request and check whether there 
-// are any available children to sent this request to. If there is not, 
-// and children_exist_ hasn't reached limit, the server can fork a new
-// child to handle this request. If the server cannot fork any more
-// children (which should not be happen, because the load balancer
-// should not send requests to a server whose max_load <= curr_load),
-// it will send back an error.
+// Read a connection from the load balancer, and dispatch every 
+// complete request in its buffer. A request split in several reads
+// stays in the buffer until the rest arrives.
 //-------------------------------------------------------------------
-Status Server::handleRequestFromClient()
+Status Server::handleRequestFromClient(int trigger_fd)
 {
-    HTTPMessage recv_msg;
-    memset(recv_msg.http_msg, 0, HTTPMessage::HTTP_MSG_SIZE);
+    ConnBuffer& buffer = conn_buffers_[trigger_fd];
+    ConnBuffer::ReadState state = buffer.readFrom(trigger_fd);
 
-    ssize_t num_read = read(client_fd_, recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
-    if (num_read == -1)
+    HTTPMessage recv_msg;
+    while (conn_buffers_.find(trigger_fd) != conn_buffers_.end() && 
+           buffer.getMessage(recv_msg))
     {
-        ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
-        eh.errMsg();
-        return FATAL_ERROR;
+        if (dispatchRequest(trigger_fd, recv_msg) == FATAL_ERROR)
+            return FATAL_ERROR;
     }
-    if (num_read == 0)
+
+    // A request which cannot be framed breaks the connection.
+    if (conn_buffers_.find(trigger_fd) != conn_buffers_.end())
+        state = buffer.getReadState();
+
+    if (state != ConnBuffer::READ_OPEN && 
+        conn_buffers_.find(trigger_fd) != conn_buffers_.end())
     {
-        fprintf(stderr, "load balancer closes socket fd\n");
-        return FATAL_ERROR;
+        if (state == ConnBuffer::READ_EOF)
+            fprintf(stderr, "load balancer closes socket fd\n");
+
+        // Only this connection is broken, other workers of the load
+        // balancer may still send requests.
+        closeClient(trigger_fd);
+        return MINOR_ERROR;
     }
 
+    return SUCCESS;
+}
+
+//-------------------------------------------------------------------
+// Handle a request from a client (load balancer). 
+// The server checks whether there are any available children to sent
+// this request to. If there is not, and children_exist_ hasn't reached
+// limit, the server can fork a new child to handle this request. If 
+// the server cannot fork any more children (which should not be 
+// happen, because the load balancer should not send requests to a 
+// server whose max_load <= curr_load), it will send back an error.
+// The child remembers the connection of the request, so the response
+// sent back by the child is written to that connection.
+//-------------------------------------------------------------------
+Status Server::dispatchRequest(int conn_fd, HTTPMessage& recv_msg)
+{
     std::cout << "===========================================\n";
     std::cout << "a real server receive:\n";
     std::cout << recv_msg.http_msg;
@@ -339,15 +379,15 @@ Status Server::handleRequestFromClient()
     // to the first free child.
     if (children_free_ > 0)
     {
-        if (write(child_pool_.at(first_free_child).child_spipe_fd[1],
-                  recv_msg.http_msg,
-                  HTTPMessage::HTTP_MSG_SIZE) == -1)
+        if (ConnBuffer::writeMessage(child_pool_.at(first_free_child).child_spipe_fd[1],
+                                     recv_msg) == -1)
         {
             ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
             eh.errMsg();
             return FATAL_ERROR;
         }
         child_pool_.at(first_free_child).child_status = BUSY;
+        child_pool_.at(first_free_child).conn_fd = conn_fd;
     }
 
     // No free children, but children_exist doesn't reach limit. Fork
@@ -363,9 +403,7 @@ Status Server::handleRequestFromClient()
             return FATAL_ERROR;
 
         VectorPos i = children_exist_;
-        if (write(child_pool_.at(i).child_spipe_fd[1], 
-                  recv_msg.http_msg, 
-                  HTTPMessage::HTTP_MSG_SIZE) == -1)
+        if (ConnBuffer::writeMessage(child_pool_.at(i).child_spipe_fd[1], recv_msg) == -1)
         {
             ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
             eh.errMsg();
@@ -373,6 +411,7 @@ Status Server::handleRequestFromClient()
         }
 
         child_pool_.at(i).child_status = BUSY;
+        child_pool_.at(i).conn_fd = conn_fd;
 
         children_exist_++;
     }
@@ -384,25 +423,63 @@ Status Server::handleRequestFromClient()
         HTTPMessage response;
         std::string source_ip;
         std::string source_port;
+        std::string request_id;
 
         getSourceIP(recv_msg, source_ip);
         getSourcetPort(recv_msg, source_port);
+        getRequestID(recv_msg, request_id);
 
         // HEAD503 = "503 Service Unavailable"
         ErrorMessage em("HTTP/1.1", StatusCode::ServerErrorStatusCode::HEAD503, source_ip, source_port);
         em.constructHTTPMsg(response);
+        if (request_id.size() > 0)
+            HTTPWriter::insertHeader(response, ("Request-ID: " + request_id).c_str());
 
-        if (write(client_fd_, response.http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
-        {
-            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__ - 1);
-            eh.errMsg();
-            return FATAL_ERROR;
-        }
+        conn_buffers_[conn_fd].queueMessage(response);
+        flushClient(conn_fd);
     }
 
     return SUCCESS;
 }
 
+//-------------------------------------------------------------------
+// Write the responses in the buffer of a connection. The connection
+// waits for EPOLLOUT only while some responses are left.
+//-------------------------------------------------------------------
+void Server::flushClient(int conn_fd)
+{
+    ConnBuffer& buffer = conn_buffers_[conn_fd];
+    if (buffer.flushTo(conn_fd) == -1)
+    {
+        closeClient(conn_fd);
+        return;
+    }
+
+    uint32_t events = EPOLLIN | (buffer.hasOutput() ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (events != buffer.getEvents())
+    {
+        modifyEvent(epoll_fd_, conn_fd, events);
+        buffer.setEvents(events);
+    }
+}
+
+//-------------------------------------------------------------------
+// Close a connection from the load balancer. Responses of requests
+// from it are dropped when the children send them back.
+//-------------------------------------------------------------------
+void Server::closeClient(int conn_fd)
+{
+    for (auto &x : child_pool_)
+    {
+        if (x.conn_fd == conn_fd)
+            x.conn_fd = -1;
+    }
+
+    deleteEvent(epoll_fd_, conn_fd);
+    conn_buffers_.erase(conn_fd);
+    close(conn_fd);
+}
+
 //-------------------------------------------------------------------
 // Add timer for every children forked when there are too many
 // requests. When a timer alarms, the corresponding child should be
@@ -425,7 +502,7 @@ Status Server::addTimer(int index)
         return FATAL_ERROR;
     }
 
-    FD_SET(timer_fd_, &timer_fds_);
+    timer_fds_.insert(timer_fd_);
     addEvent(epoll_fd_, timer_fd_, NON_ONESHOT, BLOCK);
 
     child_pool_.at(index).child_timer_fd = timer_fd_;
@@ -434,23 +511,30 @@ Status Server::addTimer(int index)
 }
 
 //-------------------------------------------------------------------
-// Handle finish message from a child.
+// Handle the response and finish message from a child. The response
+// is written to the connection of its request.
 // When a child exits, this function can also be invoked and the child
 // spipe_fd will be removed.
 //-------------------------------------------------------------------
 Status Server::handleResponseFromChild(int trigger_fd)
 {
     ssize_t num_read;
+    HTTPMessage response;
     struct ChildInfo result;
 
-    num_read = read(trigger_fd, &result, sizeof(ChildInfo));
+    // The child writes the response and the finish message together,
+    // so they are read at once. The response is sent behind its length.
+    num_read = ConnBuffer::readMessage(trigger_fd, response);
+    if (num_read == 1)
+        num_read = ConnBuffer::readFull(trigger_fd, &result, sizeof(ChildInfo));
+    
     if (num_read == -1)
     {
         ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
         eh.errMsg();
         return FATAL_ERROR;
     }
-    if (num_read == 0)
+    if (num_read < static_cast<ssize_t>(sizeof(ChildInfo)))
     {
         fprintf(stderr, "server read - end of file\n");
         deleteEvent(epoll_fd_, trigger_fd);
@@ -467,6 +551,17 @@ Status Server::handleResponseFromChild(int trigger_fd)
         return MINOR_ERROR;
     }
 
+    for (auto &x : child_pool_)
+    {
+        if (x.child_spipe_fd[1] == trigger_fd && x.conn_fd != -1)
+        {
+            conn_buffers_[x.conn_fd].queueMessage(response);
+            flushClient(x.conn_fd);
+            x.conn_fd = -1;
+            break;
+        }
+    }
+
     if (result.child_pid > 0)
     {
         int index = result.child_index;
@@ -511,7 +606,7 @@ Status Server::handleChildTimeOut(int trigger_fd)
 
             kill(it->child_pid, SIGINT);
 
-            FD_CLR(trigger_fd, &timer_fds_);
+            timer_fds_.erase(trigger_fd);
             deleteEvent(epoll_fd_, trigger_fd);
             deleteEvent(epoll_fd_, it->child_spipe_fd[1]);
             close(trigger_fd);
@@ -591,7 +686,7 @@ Status Server::serverSigHandler()
                     std::cout << "a child(>PREFORKED_CHILDREN) terminates unexpectedlly\n";
                     std::cout << "the child pid = " << it->child_pid << std::endl;
 
-                    FD_CLR(it->child_timer_fd, &timer_fds_);
+                    timer_fds_.erase(it->child_timer_fd);
                     deleteEvent(epoll_fd_, it->child_timer_fd);
                     close(it->child_timer_fd);
                     close(it->child_spipe_fd[1]);
@@ -647,19 +742,23 @@ void Server::clearAll()
     std::cout << "server shutdown...\n";
     shutdown(listen_fd_, SHUT_RDWR);
     close(listen_fd_);
-    close(client_fd_);
+
+    for (auto &x : conn_buffers_)
+    {
+        close(x.first);
+        std::cout << "close client fd " << x.first << std::endl;
+    }
+    conn_buffers_.clear();
 
     std::cout << "close epoll_fd_ " << epoll_fd_ << std::endl;
     std::cout << "close signal_fd_ " << signal_fd_ << std::endl;
     std::cout << "close listen_fd_ " << listen_fd_ << std::endl;
-    std::cout << "close client_fd_ " << client_fd_ << std::endl;
 }
 
 //-------------------------------------------------------------------
 // Child main function.
 // A child receives a request from the server, handles it and sends
-// response to the client. The child will also send a finish message
-// to the server.
+// the response back to the server, followed by a finish message.
 //-------------------------------------------------------------------
 void Server::childWork(ChildInfo &child_info)
 {
@@ -671,9 +770,8 @@ void Server::childWork(ChildInfo &child_info)
     while (true)
     {
         HTTPMessage recv_msg;
-        memset(recv_msg.http_msg, '\0', HTTPMessage::HTTP_MSG_SIZE);
 
-        ssize_t num_read = read(child_info.child_spipe_fd[0], recv_msg.http_msg, HTTPMessage::HTTP_MSG_SIZE);
+        int num_read = ConnBuffer::readMessage(child_info.child_spipe_fd[0], recv_msg);
         if (num_read == -1) 
         {
             ErrorHandler eh("read", __FILE__, __FUNCTION__, __LINE__);
@@ -692,19 +790,15 @@ void Server::childWork(ChildInfo &child_info)
 
         // If it is an HTTP message with SERVERCHECK method, the child should 
         // provide the server's max load.
-        if (strncasecmp(recv_msg.http_msg, "SERVERCHECK", 11) == 0) 
+        if (strncasecmp(recv_msg.http_msg.c_str(), "SERVERCHECK", 11) == 0) 
             reader.setMaxLoad(convertToString(max_children_));
         
         reader.start();
-        if (write(client_fd_, reader.getResponseMsg().http_msg, HTTPMessage::HTTP_MSG_SIZE) == -1)
-        {
-            ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
-            eh.errMsg();
-        }
 
-        // Send finish message to the server. The message transfered is
-        // a ChildInfo object.
-        if (write(child_pfd_, &child_info, sizeof(ChildInfo)) == -1) 
+        // Send the response and finish message to the server. The 
+        // finish message transfered is a ChildInfo object.
+        if (ConnBuffer::writeMessage(child_pfd_, reader.getResponseMsg()) == -1 ||
+            ConnBuffer::writeFull(child_pfd_, &child_info, sizeof(ChildInfo)) == -1) 
         {
             ErrorHandler eh("write", __FILE__, __FUNCTION__, __LINE__);
             eh.errMsg();
@@ -738,6 +832,7 @@ Status Server::updateChild(int index)
 {
     child_pool_[index].child_status = FREE;
     child_pool_[index].child_timer_fd = 0;
+    child_pool_[index].conn_fd = -1;
 
     if (socketpair(AF_UNIX, SOCK_STREAM, 0, child_pool_[index].child_spipe_fd) == -1)
     {
@@ -790,6 +885,7 @@ Status Server::forkChild(int index)
     child_info.child_pid = 0;
     child_info.child_status = FREE;
     child_info.child_timer_fd = 0;
+    child_info.conn_fd = -1;
 
     if (socketpair(AF_UNIX, SOCK_STREAM, 0, child_info.child_spipe_fd) == -1)
     {
@@ -8,7 +8,68 @@
 //                 chunxutang@gmail.com
 /////////////////////////////////////////////////////////////////////
 
-#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+#include "../../include/SchedulingAlgorithms/AlgorithmVisitor.h"
+
+//-------------------------------------------------------------------
+// Destructor of a scheduling algorithm
+// Stop listening to the server table.
+//-------------------------------------------------------------------
+AbstractSchedAlgorithms::~AbstractSchedAlgorithms()
+{
+    if (server_table_ != nullptr)
+        server_table_->removeListener(this);
+}
+
+//-------------------------------------------------------------------
+// Set the server table a scheduling algorithm reads.
+//-------------------------------------------------------------------
+void AbstractSchedAlgorithms::setServerTable(ServerTable *server_table)
+{
+    if (server_table_ != nullptr)
+        server_table_->removeListener(this);
+
+    server_table_ = server_table;
+    server_table_->addListener(this);
+    loadTable();
+}
+
+//-------------------------------------------------------------------
+// The servers already in the table are passed to serverAdded(), as if
+// they were added after the table is set.
+//-------------------------------------------------------------------
+void AbstractSchedAlgorithms::loadTable()
+{
+    for (int i = 0; i < server_table_->size(); i++)
+    {
+        if (server_table_->inUse(i))
+            serverAdded(i);
+    }
+}
+
+//-------------------------------------------------------------------
+// Change an IPv4 address into a unsigned integer. inet_pton() only
+// fits IPv4 address. And the result is int big-endian format.
+//-------------------------------------------------------------------
+bool AbstractSchedAlgorithms::parseIPv4(const std::string& ip, uint32_t& addr)
+{
+    in_addr svaddr;
+
+    int ret = inet_pton(AF_INET, ip.c_str(), &svaddr);
+    if (ret == 0)
+    {
+        fprintf(stderr, "IP address is not in correct format.\n");
+        return false;
+    }
+    if (ret == -1)
+    {
+        ErrorHandler eh("inet_pton", __FILE__, __FUNCTION__, __LINE__ - 6);
+        eh.errMsg();
+        return false;
+    }
+
+    addr = svaddr.s_addr;
+    return true;
+}
 
 //-------------------------------------------------------------------
 // Constructor
@@ -17,7 +78,8 @@
 // to appropriate type in selectAlgorithm() function.
 //-------------------------------------------------------------------
 AlgorithmSelector::AlgorithmSelector(SchedAlgorithm sched_type)
-    : sched_type_(sched_type_), sched_algo_(nullptr) 
+    : sched_type_(sched_type), sched_algo_(nullptr), server_table_(nullptr),
+      epsilon_(-1.0), expire_time_(0)
 {}
 
 //-------------------------------------------------------------------
@@ -29,21 +91,16 @@ AlgorithmSelector::~AlgorithmSelector()
 }
 
 //-------------------------------------------------------------------
-// Set scheduling map
-// Every time, invoke selectServer() function, sched_map needed be
-// assure of the newest version.
+// Set server table
+// The scheduling algorithm reads the servers and their loads from the
+// table, which is kept up to date by the load balancer, so it only 
+// needs to be set once.
 //-------------------------------------------------------------------
-void AlgorithmSelector::setSchedMap(const SchedMap& sched_map)
+void AlgorithmSelector::setServerTable(ServerTable *server_table)
 {
-    sched_algo_->setSchedMap(sched_map);
-}
-
-//-------------------------------------------------------------------
-// Set scheduling algorithm type
-//-------------------------------------------------------------------
-void AlgorithmSelector::setSchedType(const SchedAlgorithm sched_type) 
-{ 
-    sched_type_ = sched_type; 
+    server_table_ = server_table;
+    if (sched_algo_ != nullptr)
+        sched_algo_->setServerTable(server_table);
 }
 
 //-------------------------------------------------------------------
@@ -56,15 +113,46 @@ const SchedAlgorithm AlgorithmSelector::getSchedType()
 
 //-------------------------------------------------------------------
 // Set handle_ip, which is used in Destination Hashing and Source
-// Hashing algorithms.
+// Hashing algorithms. Other algorithms ignore it.
 //-------------------------------------------------------------------
 void AlgorithmSelector::setHandleIP(const std::string& handle_ip)
 {
-    if (sched_type_ == SchedAlgorithm::Destination_Hashing ||
-        sched_type_ == SchedAlgorithm::Source_Hashing)
+    if (sched_algo_ != nullptr)
         sched_algo_->setHandleIP(handle_ip);
 }
 
+//-------------------------------------------------------------------
+// Set epsilon of consistent hashing with bounded loads, which is used
+// in Destination Hashing and Source Hashing algorithms.
+//-------------------------------------------------------------------
+void AlgorithmSelector::setLoadBound(double epsilon)
+{
+    epsilon_ = epsilon;
+    if (sched_algo_ != nullptr)
+        sched_algo_->setLoadBound(epsilon);
+}
+
+//-------------------------------------------------------------------
+// Set the URL of a request, which is used in Locality-Based Least
+// Connection algorithm.
+//-------------------------------------------------------------------
+void AlgorithmSelector::setHandleURL(const std::string& url)
+{
+    if (sched_algo_ != nullptr)
+        sched_algo_->setHandleURL(url);
+}
+
+//-------------------------------------------------------------------
+// Set the time in seconds after which an unused destination is
+// forgotten by Locality-Based Least Connection algorithm.
+//-------------------------------------------------------------------
+void AlgorithmSelector::setExpireTime(int seconds)
+{
+    expire_time_ = seconds;
+    if (sched_algo_ != nullptr)
+        sched_algo_->setExpireTime(seconds);
+}
+
 //-------------------------------------------------------------------
 // Get scheduling algorithm pointer
 //-------------------------------------------------------------------
@@ -82,32 +170,69 @@ int AlgorithmSelector::selectServer()
     return sched_algo_->selectServer(); 
 }
 
+//-------------------------------------------------------------------
+// Create an object of the algorithm visitAlgorithm() finds.
+//-------------------------------------------------------------------
+struct AlgorithmCreator
+{
+    AbstractSchedAlgorithms *& sched_algo;
+
+    template <typename Algorithm>
+    void operator()(AlgorithmTag<Algorithm>)
+    {
+        sched_algo = new Algorithm();
+    }
+};
+
 //-------------------------------------------------------------------
 // Cast scheduling algorithm pointer to appropriate type
 //-------------------------------------------------------------------
 void AlgorithmSelector::selectAlgorithm()
 {
-    switch (sched_type_)
+    AlgorithmCreator creator = { sched_algo_ };
+    visitAlgorithm(sched_type_, creator);
+
+    if (sched_algo_ != nullptr)
+        configure(sched_algo_);
+}
+
+//-------------------------------------------------------------------
+// Set scheduling algorithm type. If an algorithm has been selected, a
+// new algorithm of the type is built completely from the server table
+// before it replaces the old one, which is deleted, so a selection
+// always sees one whole algorithm. Loads are kept in the server table,
+// so requests in flight are still counted by the new algorithm. It is
+// also the way to rebuild an algorithm after max loads have changed.
+// return: false if the type is not known, the old algorithm is kept
+//-------------------------------------------------------------------
+bool AlgorithmSelector::setSchedType(const SchedAlgorithm sched_type) 
+{ 
+    if (sched_algo_ == nullptr)
     {
-    case Round_Robin:
-        sched_algo_ = new SchedRR();
-        break;
-    case Weighted_Round_Robin:
-        sched_algo_ = new SchedWRR();
-        break;
-    case Least_Connection:
-        sched_algo_ = new SchedLC();
-        break;
-    case Weighted_Least_Connection:
-        sched_algo_ = new SchedWLC();
-        break;
-    case Destination_Hashing:
-        sched_algo_ = new SchedDH();
-        break;
-    case Source_Hashing:
-        sched_algo_ = new SchedSH();
-        break;
-    default:
-        break;;
+        sched_type_ = sched_type;
+        return true;
     }
+
+    AbstractSchedAlgorithms *sched_algo = nullptr;
+    AlgorithmCreator creator = { sched_algo };
+    if (!visitAlgorithm(sched_type, creator))
+        return false;
+
+    configure(sched_algo);
+    std::swap(sched_algo_, sched_algo);
+    delete sched_algo;
+    sched_type_ = sched_type;
+    return true;
+}
+
+//-------------------------------------------------------------------
+// Give a new algorithm the server table and the options given before
+//-------------------------------------------------------------------
+void AlgorithmSelector::configure(AbstractSchedAlgorithms *sched_algo)
+{
+    if (server_table_ != nullptr)
+        sched_algo->setServerTable(server_table_);
+    sched_algo->setLoadBound(epsilon_);
+    if (expire_time_ > 0)
+        sched_algo->setExpireTime(expire_time_);
 }
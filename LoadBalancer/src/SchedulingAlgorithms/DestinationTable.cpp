@@ -0,0 +1,182 @@
+/////////////////////////////////////////////////////////////////////
+//  DestinationTable.cpp - implementation of DestinationTable class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/DestinationTable.h"
+
+//-------------------------------------------------------------------
+// Constructor
+// The table is full at 3/4 of its slots, so that runs of linear
+// probing stay short.
+//-------------------------------------------------------------------
+DestinationTable::DestinationTable(size_t capacity)
+    : size_(0), hand_(0), expire_time_(24 * 60 * 60)
+{
+    size_t slot_count = 4;
+    while (slot_count < capacity)
+        slot_count <<= 1;
+
+    Entry empty = { 0, -1, -1, 0, false };
+    slots_.assign(slot_count, empty);
+    mask_ = slot_count - 1;
+    max_size_ = slot_count / 4 * 3;
+}
+
+//-------------------------------------------------------------------
+// Take all the entries out
+//-------------------------------------------------------------------
+void DestinationTable::clear()
+{
+    for (auto& x : slots_)
+        x.hash = 0;
+    size_ = 0;
+}
+
+//-------------------------------------------------------------------
+// Find the entry of a destination. The clock hand moves on first, so
+// an expired entry is not returned if the hand reaches it.
+//-------------------------------------------------------------------
+DestinationTable::Entry* DestinationTable::find(uint64_t hash, time_t now)
+{
+    sweep(now);
+
+    for (size_t slot = home(hash); slots_[slot].hash != 0; slot = (slot + 1) & mask_)
+    {
+        Entry& entry = slots_[slot];
+        if (entry.hash != hash)
+            continue;
+
+        if (now - entry.last_used > expire_time_)
+        {
+            erase(slot);
+            return nullptr;
+        }
+
+        entry.last_used = now;
+        entry.referenced = true;
+        return &entry;
+    }
+
+    return nullptr;
+}
+
+//-------------------------------------------------------------------
+// Assign a server to a destination, replacing the server assigned to
+// it before. If the table is full, an entry is evicted first.
+//-------------------------------------------------------------------
+void DestinationTable::set(uint64_t hash, int index, int fd, time_t now)
+{
+    size_t slot = home(hash);
+    while (slots_[slot].hash != 0 && slots_[slot].hash != hash)
+        slot = (slot + 1) & mask_;
+
+    if (slots_[slot].hash == 0)
+    {
+        if (size_ >= max_size_)
+        {
+            evict();
+            // The run may have been shifted, find a free slot again.
+            slot = home(hash);
+            while (slots_[slot].hash != 0)
+                slot = (slot + 1) & mask_;
+        }
+        size_++;
+    }
+
+    Entry entry = { hash, index, fd, now, true };
+    slots_[slot] = entry;
+}
+
+//-------------------------------------------------------------------
+// Take an entry out. The following entries of the run, which are not
+// at their home slots, are moved back, so that every entry can still
+// be reached from its home slot without passing an empty slot.
+//-------------------------------------------------------------------
+void DestinationTable::erase(size_t slot)
+{
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask_;
+
+    while (slots_[next].hash != 0)
+    {
+        // distance of the entry at next from its home slot, and of
+        // the hole from the same home slot
+        size_t home_slot = home(slots_[next].hash);
+        if (((next - home_slot) & mask_) >= ((next - hole) & mask_))
+        {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+        next = (next + 1) & mask_;
+    }
+
+    slots_[hole].hash = 0;
+    size_--;
+}
+
+//-------------------------------------------------------------------
+// Move the clock hand SWEEP_STEP slots on, and take out the entries it
+// passes which have not been used for expire time. When an entry is
+// taken out, another may be shifted into its slot, so the slot is
+// checked again.
+//-------------------------------------------------------------------
+void DestinationTable::sweep(time_t now)
+{
+    for (size_t i = 0; i < SWEEP_STEP && size_ > 0; i++)
+    {
+        Entry& entry = slots_[hand_];
+        if (entry.hash != 0 && now - entry.last_used > expire_time_)
+            erase(hand_);
+        else
+        {
+            entry.referenced = false;
+            hand_ = (hand_ + 1) & mask_;
+        }
+    }
+}
+
+//-------------------------------------------------------------------
+// Take out the first entry the clock hand reaches which has not been
+// used since the hand passed it last time.
+//-------------------------------------------------------------------
+void DestinationTable::evict()
+{
+    while (true)
+    {
+        Entry& entry = slots_[hand_];
+        if (entry.hash != 0)
+        {
+            if (!entry.referenced)
+            {
+                erase(hand_);
+                return;
+            }
+            entry.referenced = false;
+        }
+        hand_ = (hand_ + 1) & mask_;
+    }
+}
+
+//-------------------------------------------------------------------
+// 64-bit FNV-1a hash of a destination. 0 marks an empty slot, so it is
+// changed to 1.
+//-------------------------------------------------------------------
+uint64_t DestinationTable::hashKey(const std::string& key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    // Mix high bits into the low bits used as the home slot.
+    hash ^= hash >> 32;
+    return (hash == 0) ? 1 : hash;
+}
@@ -0,0 +1,105 @@
+/////////////////////////////////////////////////////////////////////
+//  HashRing.cpp - implementation of HashRing class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "../../include/SchedulingAlgorithms/HashRing.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+HashRing::HashRing()
+    : server_table_(nullptr)
+{}
+
+//-------------------------------------------------------------------
+// Set the table the servers come from. The ring is cleared.
+//-------------------------------------------------------------------
+void HashRing::setServerTable(const ServerTable *server_table)
+{
+    server_table_ = server_table;
+    clear();
+}
+
+//-------------------------------------------------------------------
+// Take all the points off the ring
+//-------------------------------------------------------------------
+void HashRing::clear()
+{
+    points_.clear();
+}
+
+//-------------------------------------------------------------------
+// Put the points of a server on the ring. The points of a server are
+// hashed from "address:port-i" with FNV-1a, then mixed by hashKey(),
+// and merged into the sorted array.
+//-------------------------------------------------------------------
+void HashRing::add(int index)
+{
+    const RealServer& server = server_table_->get(index);
+    std::string name = server.address + ":" + server.port_num + "-";
+
+    long long count = static_cast<long long>(server.max_load) * POINTS_PER_LOAD;
+    count = std::min(std::max(count, static_cast<long long>(MIN_POINTS)),
+                     static_cast<long long>(MAX_POINTS));
+
+    size_t old_size = points_.size();
+    for (int i = 0; i < count; i++)
+    {
+        std::string point_name = name + std::to_string(i);
+        uint32_t hash = 2166136261U;
+        for (char c : point_name)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619U;
+        }
+
+        Point point = { hashKey(hash), index };
+        points_.push_back(point);
+    }
+
+    std::sort(points_.begin() + old_size, points_.end());
+    std::inplace_merge(points_.begin(), points_.begin() + old_size, points_.end());
+}
+
+//-------------------------------------------------------------------
+// Take the points of a server off the ring. The order of other points
+// is kept.
+//-------------------------------------------------------------------
+void HashRing::remove(int index)
+{
+    points_.erase(std::remove_if(points_.begin(), points_.end(),
+                                 [index](const Point& p) { return p.index == index; }),
+                  points_.end());
+}
+
+//-------------------------------------------------------------------
+// Binary search for the first point at or after hash. A hash after
+// the last point wraps round to the first one.
+//-------------------------------------------------------------------
+size_t HashRing::lookup(uint32_t hash) const
+{
+    auto it = std::lower_bound(points_.begin(), points_.end(), hash,
+                               [](const Point& p, uint32_t h) { return p.hash < h; });
+    return (it == points_.end()) ? 0 : it - points_.begin();
+}
+
+//-------------------------------------------------------------------
+// Finalizer of MurmurHash3. Keys close to each other, such as the
+// addresses of one subnet, are spread over the whole ring.
+//-------------------------------------------------------------------
+uint32_t HashRing::hashKey(uint32_t key)
+{
+    key ^= key >> 16;
+    key *= 0x85ebca6bU;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35U;
+    key ^= key >> 16;
+    return key;
+}
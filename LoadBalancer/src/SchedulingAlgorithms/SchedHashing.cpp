@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedHashing.cpp - implementation of base class of hashing
+//                     algorithms
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Select server by mapping an IP address to the servers with a
+// consistent hash ring.
+// return : >0  file descriptor of selected server's socket
+//           0  occur one error
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedHashing::selectByIP(const std::string& ip)
+{
+    uint32_t addr;
+    if (!parseIPv4(ip, addr))
+        return 0;
+
+    if (ring_.empty() || available_ <= 0)
+        return -1;
+
+    // If the hashed server is not available, or over the bound of
+    // load, walk round the ring to find next server. Points of the
+    // servers already tried are passed over, and the walk stops when
+    // every server has been tried once.
+    size_t pos = ring_.lookup(HashRing::hashKey(addr));
+    int index = ring_.getServer(pos);
+    if (!isAvailable(index) || !underBound(index))
+    {
+        if (++visit_ == 0)
+        {
+            std::fill(tried_.begin(), tried_.end(), 0);
+            visit_ = 1;
+        }
+        tried_[index] = visit_;
+
+        int untried = server_count_ - 1;
+        while (true)
+        {
+            if (untried == 0)
+                return -1;
+            pos = ring_.next(pos);
+            index = ring_.getServer(pos);
+            if (tried_[index] == visit_)
+                continue;
+
+            tried_[index] = visit_;
+            untried--;
+            if (isAvailable(index) && underBound(index))
+                break;
+        }
+    }
+
+    DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+    return server_table_->getFd(index);
+}
+
+//-------------------------------------------------------------------
+// Whether a server can take one more request under the bound of
+// load. The bound of a server is
+//     ceil((1 + epsilon) * (total load + 1) * weight / total weight)
+// counting the request being scheduled, so the bounds add up to more
+// than the total load and some server is always under its bound.
+//-------------------------------------------------------------------
+bool SchedHashing::underBound(int index) const
+{
+    if (epsilon_ < 0 || total_weight_ <= 0)
+        return true;
+
+    const RealServer& server = server_table_->get(index);
+    double bound = (1.0 + epsilon_) * (total_load_ + 1) * weight(server) / total_weight_;
+    return server.cur_load < std::ceil(bound);
+}
+
+//-------------------------------------------------------------------
+// Weight of a server on the ring and in the bound of load
+//-------------------------------------------------------------------
+int SchedHashing::weight(const RealServer& server)
+{
+    return std::max(server.max_load, 1);
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table
+//-------------------------------------------------------------------
+void SchedHashing::serverAdded(int index)
+{
+    ring_.add(index);
+    server_count_++;
+    if (index >= static_cast<int>(tried_.size()))
+        tried_.resize(index + 1, 0);
+
+    const RealServer& server = server_table_->get(index);
+    total_load_ += server.cur_load;
+    total_weight_ += weight(server);
+    if (hasCapacity(server))
+        available_++;
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table. Its slot still holds
+// its load and max load.
+//-------------------------------------------------------------------
+void SchedHashing::serverRemoved(int index)
+{
+    ring_.remove(index);
+    server_count_--;
+
+    const RealServer& server = server_table_->get(index);
+    total_load_ -= server.cur_load;
+    total_weight_ -= weight(server);
+    if (hasCapacity(server))
+        available_--;
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes
+//-------------------------------------------------------------------
+void SchedHashing::loadChanged(int index, int old_load)
+{
+    if (server_table_->inUse(index))
+    {
+        total_load_ += server_table_->get(index).cur_load - old_load;
+        available_ += capacityChange(index, old_load);
+    }
+}
+
+//-------------------------------------------------------------------
+// Put all the servers of a new table on the ring.
+//-------------------------------------------------------------------
+void SchedHashing::loadTable()
+{
+    ring_.setServerTable(server_table_);
+    total_load_ = 0;
+    total_weight_ = 0;
+    server_count_ = 0;
+    available_ = 0;
+    AbstractSchedAlgorithms::loadTable();
+}
@@ -0,0 +1,75 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedHeap.cpp - implementation of base class of algorithms on a
+//                  heap of servers
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Select the least server. The heap only holds servers which have
+// enough capacity to handle a request, so its top is selected.
+// return : >0  file descriptor of selected server's socket
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedHeap::selectServer()
+{
+    if (heap_.empty())
+        return -1;
+
+    int index = heap_.top();
+    DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+    return server_table_->getFd(index);
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table
+//-------------------------------------------------------------------
+void SchedHeap::serverAdded(int index)
+{
+    refresh(index);
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedHeap::serverRemoved(int index)
+{
+    heap_.erase(index);
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes. Its place in the heap changes, and it may
+// become saturated or available.
+//-------------------------------------------------------------------
+void SchedHeap::loadChanged(int index, int)
+{
+    refresh(index);
+}
+
+//-------------------------------------------------------------------
+// Put all the servers with capacity of a new table into the heap.
+//-------------------------------------------------------------------
+void SchedHeap::loadTable()
+{
+    heap_.setServerTable(server_table_);
+    for (int i = 0; i < server_table_->size(); i++)
+        refresh(i);
+}
+
+//-------------------------------------------------------------------
+// Keep a server in the heap at its place if it is available, or take
+// it out.
+//-------------------------------------------------------------------
+void SchedHeap::refresh(int index)
+{
+    if (isAvailable(index))
+        heap_.update(index);
+    else
+        heap_.erase(index);
+}
@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedLBLC.cpp - implementation of Locality-Based Least Connection
+//                  algorithm
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+SchedLBLC::SchedLBLC()
+    : SchedHeap(SchedWLC::lessWeightedLoad), table_(TABLE_CAPACITY)
+{}
+
+//-------------------------------------------------------------------
+// Set the time in seconds after which the server of a destination is
+// forgotten if the destination is not requested.
+//-------------------------------------------------------------------
+void SchedLBLC::setExpireTime(int seconds)
+{
+    if (seconds > 0)
+        table_.setExpireTime(seconds);
+}
+
+//-------------------------------------------------------------------
+// Select the server assigned to the destination. If there is none, or
+// it is gone or overloaded, select the server with weighted least
+// connection and assign it to the destination.
+// return : >0  file descriptor of selected server's socket
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedLBLC::selectServer()
+{
+    time_t now = time(NULL);
+    uint64_t hash = DestinationTable::hashKey(key_);
+
+    DestinationTable::Entry *entry = table_.find(hash, now);
+    if (entry != nullptr && server_table_->getFd(entry->index) == entry->fd &&
+        server_table_->inUse(entry->index) && !isOverloaded(entry->index))
+    {
+        DebugCode(std::cout << "selected server: " << entry->fd << std::endl;)
+        return entry->fd;
+    }
+
+    if (heap_.empty())
+        return -1;
+
+    int index = heap_.top();
+    int fd = server_table_->getFd(index);
+    table_.set(hash, index, fd, now);
+
+    DebugCode(std::cout << "selected server: " << fd << std::endl;)
+    return fd;
+}
+
+//-------------------------------------------------------------------
+// Put all the servers with capacity of a new table into the heap. The
+// assignments of the old table are forgotten.
+//-------------------------------------------------------------------
+void SchedLBLC::loadTable()
+{
+    table_.clear();
+    SchedHeap::loadTable();
+}
+
+//-------------------------------------------------------------------
+// A server is overloaded if it is saturated, or if it is busy at more
+// than half of its max load while the least loaded server is at less
+// than a quarter of its own. The least loaded server is the top of
+// the heap.
+//-------------------------------------------------------------------
+bool SchedLBLC::isOverloaded(int index) const
+{
+    if (!isAvailable(index))
+        return true;
+
+    const RealServer& server = server_table_->get(index);
+    if (server.cur_load * 2 <= server.max_load || heap_.empty())
+        return false;
+
+    const RealServer& least = server_table_->get(heap_.top());
+    return least.cur_load * 4 < least.max_load;
+}
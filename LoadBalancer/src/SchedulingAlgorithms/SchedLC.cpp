@@ -11,38 +11,9 @@
 #include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
 
 //-------------------------------------------------------------------
-// Select server which has least connection, which is represented by
-// current load.
-// return : >0  file descriptor of selected server's socket
-//          -1  no available server 
+// Servers are compared by current load.
 //-------------------------------------------------------------------
-int SchedLC::selectServer()
+bool SchedLC::lessLoad(const RealServer& a, const RealServer& b)
 {
-    SchedMap::iterator it = sched_map_.begin();
-    int handle_fd = it->first;
-
-    for (; it != sched_map_.end(); it++) 
-    {
-        // First select a server who has enough capacity to 
-        // handle a request. If there's not one available,
-        // the for loop will be terminated, and return -1.
-        if (it->second.cur_load >= it->second.max_load - RESERVED_CAPACITY)
-            continue;
-
-        SchedMap::iterator it2 = it;
-        it2++;
-
-        // Traverse the left servers to find whether there is
-        // one server's connection is less than this one.
-        for (; it2 != sched_map_.end(); it2++) 
-        {
-            if (it->second.cur_load > it2->second.cur_load)
-                it = it2;
-        }
-
-        DebugCode(std::cout << "selected server: " << it->first << std::endl;)
-        return it->first;
-    }
-
-    return -1;
+    return a.cur_load < b.cur_load;
 }
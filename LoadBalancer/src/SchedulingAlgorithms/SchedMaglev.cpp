@@ -0,0 +1,303 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedMaglev.cpp - implementation of Maglev Hashing algorithm
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+const int SchedMaglev::TABLE_SIZE;
+
+//-------------------------------------------------------------------
+// FNV-1a hash of a string, started from seed, and mixed by the
+// finalizer of the hash ring.
+//-------------------------------------------------------------------
+static uint32_t hashName(const std::string& name, uint32_t seed)
+{
+    uint32_t hash = seed;
+    for (char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619U;
+    }
+    return HashRing::hashKey(hash);
+}
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+SchedMaglev::SchedMaglev()
+    : available_(0), generation_(0), builder_started_(false), pending_generation_(0),
+      build_pending_(false), stop_(false)
+{
+    pthread_mutex_init(&mtx_, NULL);
+    pthread_cond_init(&cond_, NULL);
+}
+
+//-------------------------------------------------------------------
+// Destructor
+// Stop the builder thread and wait for it.
+//-------------------------------------------------------------------
+SchedMaglev::~SchedMaglev()
+{
+    if (builder_started_)
+    {
+        pthread_mutex_lock(&mtx_);
+        stop_ = true;
+        pthread_cond_signal(&cond_);
+        pthread_mutex_unlock(&mtx_);
+        pthread_join(builder_, NULL);
+    }
+
+    pthread_cond_destroy(&cond_);
+    pthread_mutex_destroy(&mtx_);
+}
+
+//-------------------------------------------------------------------
+// Select the server of the entry the source IP address is hashed to.
+// If it is not available, the following entries are tried.
+// return : >0  file descriptor of selected server's socket
+//           0  occur one error
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedMaglev::selectServer()
+{
+    uint32_t addr;
+    if (!parseIPv4(source_ip_, addr))
+        return 0;
+
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+    if (!table || available_.load(std::memory_order_relaxed) <= 0)
+        return -1;
+
+    int entry = HashRing::hashKey(addr) % TABLE_SIZE;
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        // An entry of an old table may belong to a server which has
+        // been removed, or whose slot is taken by another server.
+        int index = table->entries[entry];
+        if (index >= 0 && index < server_table_->size() &&
+            table->fds[index] == server_table_->getFd(index) && isAvailable(index))
+        {
+            DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+            return server_table_->getFd(index);
+        }
+
+        entry = (entry + 1 == TABLE_SIZE) ? 0 : entry + 1;
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table
+//-------------------------------------------------------------------
+void SchedMaglev::serverAdded(int)
+{
+    requestBuild();
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedMaglev::serverRemoved(int)
+{
+    requestBuild();
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes, which may make it saturated or available
+//-------------------------------------------------------------------
+void SchedMaglev::loadChanged(int index, int old_load)
+{
+    available_ += capacityChange(index, old_load);
+}
+
+//-------------------------------------------------------------------
+// All the servers of a new table are taken at once.
+//-------------------------------------------------------------------
+void SchedMaglev::loadTable()
+{
+    requestBuild();
+}
+
+//-------------------------------------------------------------------
+// Copy the servers in the table and give them to the builder thread.
+// A copy not taken by the builder yet is replaced. If no server of
+// the current table is left, e.g. the first servers are added after an
+// empty table is loaded, the new table is built here, so that
+// requests are not refused until the builder is done.
+//-------------------------------------------------------------------
+void SchedMaglev::requestBuild()
+{
+    std::vector<Backend> backends;
+    int available = 0;
+
+    for (int i = 0; i < server_table_->size(); i++)
+    {
+        if (!server_table_->inUse(i))
+            continue;
+
+        const RealServer& server = server_table_->get(i);
+        Backend backend = { i, server_table_->getFd(i), server.max_load,
+                            server.address + ":" + server.port_num };
+        backends.push_back(backend);
+        if (isAvailable(i))
+            available++;
+    }
+    available_ = available;
+    generation_++;
+
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+    bool usable = false;
+    for (size_t i = 0; table && i < backends.size() && !usable; i++)
+    {
+        int index = backends[i].index;
+        usable = index < static_cast<int>(table->fds.size()) &&
+                 table->fds[index] == backends[i].fd;
+    }
+
+    if (!usable)
+    {
+        storeTable(build(backends, generation_));
+        return;
+    }
+
+    pthread_mutex_lock(&mtx_);
+    pending_.swap(backends);
+    pending_generation_ = generation_;
+    build_pending_ = true;
+    pthread_cond_signal(&cond_);
+    pthread_mutex_unlock(&mtx_);
+
+    if (!builder_started_)
+    {
+        int s = pthread_create(&builder_, NULL, runBuilder, this);
+        if (s != 0)
+        {
+            errno = s;
+            ErrorHandler eh("pthread_create", __FILE__, __FUNCTION__, __LINE__ - 4);
+            eh.errMsg();
+
+            // Build it here instead.
+            pthread_mutex_lock(&mtx_);
+            build_pending_ = false;
+            backends.swap(pending_);
+            pthread_mutex_unlock(&mtx_);
+            storeTable(build(backends, generation_));
+            return;
+        }
+        builder_started_ = true;
+    }
+}
+
+//-------------------------------------------------------------------
+// Build a lookup table. Every server has a permutation of the entries:
+// offset, offset + skip, offset + 2 * skip, ... modulo TABLE_SIZE,
+// which covers all the entries because TABLE_SIZE is a prime. In every
+// round, a server earns credit by its weight, and claims the next free
+// entry of its permutation for each max weight of credit, so the
+// heaviest server claims one entry per round.
+//-------------------------------------------------------------------
+std::shared_ptr<const SchedMaglev::Table> SchedMaglev::build(const std::vector<Backend>& backends,
+                                                            unsigned long generation)
+{
+    std::shared_ptr<Table> table = std::make_shared<Table>();
+    table->generation = generation;
+    table->entries.assign(TABLE_SIZE, -1);
+    if (backends.empty())
+        return table;
+
+    int n = backends.size();
+    int max_weight = 1;
+    int max_index = 0;
+    for (const Backend& x : backends)
+    {
+        max_weight = std::max(max_weight, x.weight);
+        max_index = std::max(max_index, x.index);
+    }
+
+    table->fds.assign(max_index + 1, -1);
+    std::vector<uint32_t> offset(n), skip(n), next(n, 0);
+    std::vector<int> credit(n, 0);
+    for (int i = 0; i < n; i++)
+    {
+        table->fds[backends[i].index] = backends[i].fd;
+        offset[i] = hashName(backends[i].name, 2166136261U) % TABLE_SIZE;
+        skip[i] = hashName(backends[i].name, 0x9747b28cU) % (TABLE_SIZE - 1) + 1;
+    }
+
+    int filled = 0;
+    while (true)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            credit[i] += std::max(backends[i].weight, 1);
+            while (credit[i] >= max_weight)
+            {
+                credit[i] -= max_weight;
+
+                uint32_t entry;
+                do
+                {
+                    entry = (offset[i] + static_cast<uint64_t>(next[i]) * skip[i]) % TABLE_SIZE;
+                    next[i]++;
+                } while (table->entries[entry] >= 0);
+
+                table->entries[entry] = backends[i].index;
+                if (++filled == TABLE_SIZE)
+                    return table;
+            }
+        }
+    }
+}
+
+//-------------------------------------------------------------------
+// Swap a new table in, unless a table of a later request is already
+// in. The builder may finish a table after a later one is built in
+// the event loop.
+//-------------------------------------------------------------------
+void SchedMaglev::storeTable(std::shared_ptr<const Table> table)
+{
+    pthread_mutex_lock(&mtx_);
+    std::shared_ptr<const Table> current = std::atomic_load(&table_);
+    if (!current || current->generation < table->generation)
+        std::atomic_store(&table_, table);
+    pthread_mutex_unlock(&mtx_);
+}
+
+//-------------------------------------------------------------------
+// Main function of the builder thread. It waits for servers to build
+// a table from, and swaps the new table in.
+//-------------------------------------------------------------------
+void* SchedMaglev::runBuilder(void *arg)
+{
+    SchedMaglev *sched = static_cast<SchedMaglev*>(arg);
+    std::vector<Backend> backends;
+    unsigned long generation;
+
+    while (true)
+    {
+        pthread_mutex_lock(&sched->mtx_);
+        while (!sched->build_pending_ && !sched->stop_)
+            pthread_cond_wait(&sched->cond_, &sched->mtx_);
+        if (sched->stop_)
+        {
+            pthread_mutex_unlock(&sched->mtx_);
+            break;
+        }
+        backends.swap(sched->pending_);
+        generation = sched->pending_generation_;
+        sched->build_pending_ = false;
+        pthread_mutex_unlock(&sched->mtx_);
+
+        sched->storeTable(build(backends, generation));
+        DebugCode(std::cout << "Maglev table built for " << backends.size() << " servers\n";)
+    }
+
+    return NULL;
+}
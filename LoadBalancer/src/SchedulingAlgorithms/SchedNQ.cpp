@@ -0,0 +1,70 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedNQ.cpp - implementation of Never Queue algorithm
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Select an idle server if there is one, otherwise select the server
+// which has the shortest expected delay. Both heaps only hold servers
+// which have enough capacity to handle a request.
+// return : >0  file descriptor of selected server's socket
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedNQ::selectServer()
+{
+    int index;
+    if (!idle_.empty())
+        index = idle_.top();
+    else if (!heap_.empty())
+        index = heap_.top();
+    else
+        return -1;
+
+    DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+    return server_table_->getFd(index);
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedNQ::serverRemoved(int index)
+{
+    heap_.erase(index);
+    idle_.erase(index);
+}
+
+//-------------------------------------------------------------------
+// Put all the servers with capacity of a new table into the heaps.
+//-------------------------------------------------------------------
+void SchedNQ::loadTable()
+{
+    idle_.setServerTable(server_table_);
+    SchedHeap::loadTable();
+}
+
+//-------------------------------------------------------------------
+// Keep a server in the heaps it belongs to, at its place, and take it
+// out of the others.
+//-------------------------------------------------------------------
+void SchedNQ::refresh(int index)
+{
+    if (!isAvailable(index))
+    {
+        heap_.erase(index);
+        idle_.erase(index);
+        return;
+    }
+
+    heap_.update(index);
+    if (server_table_->get(index).cur_load == 0)
+        idle_.update(index);
+    else
+        idle_.erase(index);
+}
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedP2C.cpp - implementation of Power of Two Choices algorithm
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <unistd.h>
+#include <time.h>
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Constructor. The generator is seeded at the first selection, so
+// workers forked from one process do not make the same choices.
+//-------------------------------------------------------------------
+SchedP2C::SchedP2C(bool weighted)
+    : weighted_(weighted), seed_(0)
+{}
+
+//-------------------------------------------------------------------
+// Pick two different servers with capacity at random, and select the
+// one with lower load. Only one server has capacity, it is selected.
+// return : >0  file descriptor of selected server's socket
+//          -1  no available server
+//-------------------------------------------------------------------
+int SchedP2C::selectServer()
+{
+    uint32_t size = available_.size();
+    if (size == 0)
+        return -1;
+
+    int index = available_[0];
+    if (size > 1)
+    {
+        uint32_t first = random() % size;
+        uint32_t second = random() % (size - 1);
+        if (second >= first)
+            second++;
+
+        int a = available_[first];
+        int b = available_[second];
+        index = lessLoad(b, a) ? b : a;
+    }
+
+    DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+    return server_table_->getFd(index);
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table
+//-------------------------------------------------------------------
+void SchedP2C::serverAdded(int index)
+{
+    refresh(index);
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedP2C::serverRemoved(int index)
+{
+    erase(index);
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes. It may become saturated or available.
+//-------------------------------------------------------------------
+void SchedP2C::loadChanged(int index, int old_load)
+{
+    if (capacityChange(index, old_load) != 0)
+        refresh(index);
+}
+
+//-------------------------------------------------------------------
+// Put all the servers with capacity of a new table into the array.
+//-------------------------------------------------------------------
+void SchedP2C::loadTable()
+{
+    available_.clear();
+    position_.assign(server_table_->size(), -1);
+    for (int i = 0; i < server_table_->size(); i++)
+        refresh(i);
+}
+
+//-------------------------------------------------------------------
+// Keep a server in the array if it is available, or take it out.
+//-------------------------------------------------------------------
+void SchedP2C::refresh(int index)
+{
+    if (isAvailable(index))
+        insert(index);
+    else
+        erase(index);
+}
+
+//-------------------------------------------------------------------
+// Append a server to the array, if it is not there.
+//-------------------------------------------------------------------
+void SchedP2C::insert(int index)
+{
+    if (index >= static_cast<int>(position_.size()))
+        position_.resize(index + 1, -1);
+    if (position_[index] != -1)
+        return;
+
+    position_[index] = available_.size();
+    available_.push_back(index);
+}
+
+//-------------------------------------------------------------------
+// Take a server out of the array. The last server fills its place.
+//-------------------------------------------------------------------
+void SchedP2C::erase(int index)
+{
+    if (index >= static_cast<int>(position_.size()) || position_[index] == -1)
+        return;
+
+    int pos = position_[index];
+    int last = available_.back();
+    available_[pos] = last;
+    position_[last] = pos;
+    available_.pop_back();
+    position_[index] = -1;
+}
+
+//-------------------------------------------------------------------
+// Compare servers by current load, or by current load / max load if
+// weighted. Products are used instead of division.
+//-------------------------------------------------------------------
+bool SchedP2C::lessLoad(int a, int b) const
+{
+    const RealServer& server_a = server_table_->get(a);
+    const RealServer& server_b = server_table_->get(b);
+
+    if (!weighted_)
+        return server_a.cur_load < server_b.cur_load;
+
+    return static_cast<long long>(server_a.cur_load) * server_b.max_load <
+           static_cast<long long>(server_b.cur_load) * server_a.max_load;
+}
+
+//-------------------------------------------------------------------
+// xorshift64* generator, good enough to pick servers and cheap.
+//-------------------------------------------------------------------
+uint32_t SchedP2C::random()
+{
+    if (seed_ == 0)
+    {
+        seed_ = (static_cast<uint64_t>(getpid()) << 32) ^ time(nullptr) ^
+                reinterpret_cast<uintptr_t>(this);
+        if (seed_ == 0)
+            seed_ = 1;
+    }
+
+    seed_ ^= seed_ >> 12;
+    seed_ ^= seed_ << 25;
+    seed_ ^= seed_ >> 27;
+    return static_cast<uint32_t>((seed_ * 2685821657736338717ULL) >> 32);
+}
@@ -0,0 +1,37 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedPeakEWMA.cpp - implementation of Peak EWMA algorithm
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// A response time of a server is measured. Its place in the heap
+// changes.
+//-------------------------------------------------------------------
+void SchedPeakEWMA::latencyChanged(int index)
+{
+    refresh(index);
+}
+
+//-------------------------------------------------------------------
+// Expected time for a server to finish one more request
+//-------------------------------------------------------------------
+double SchedPeakEWMA::cost(const RealServer& server)
+{
+    double latency = (server.latency < 1.0) ? 1.0 : server.latency;
+    return latency * (server.cur_load + 1);
+}
+
+//-------------------------------------------------------------------
+// Servers are compared by their costs.
+//-------------------------------------------------------------------
+bool SchedPeakEWMA::lessCost(const RealServer& a, const RealServer& b)
+{
+    return cost(a) < cost(b);
+}
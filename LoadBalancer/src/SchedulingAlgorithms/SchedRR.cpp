@@ -13,32 +13,81 @@
 
 //-------------------------------------------------------------------
 // Select servers one by one, sequentially. If a server is not 
-// available, select next server.
+// available, select next server. A saturated server costs one more
+// step, and all the servers are tried at most once.
 // return : >0  file descriptor of selected server's socket
 //          -1  no available server 
 //-------------------------------------------------------------------
 int SchedRR::selectServer()
 {
-    static int count = 1;
-    int offset = count % sched_map_.size();
-    SchedMap::iterator it = sched_map_.begin();
-    std::advance(it, offset);
-    SchedMap::iterator backup = it;
-    count++;
-
-    // The loop terminate condition is that iterator it equals to
-    // backup iterator, which means all the servers have been 
-    // traversed and there's no server available.
-    while (it->second.cur_load >= it->second.max_load - RESERVED_CAPACITY) 
+    int size = servers_.size();
+    if (size == 0 || available_.load(std::memory_order_relaxed) <= 0)
+        return -1;
+
+    for (int i = 0; i < size; i++)
+    {
+        int index = servers_[next_.fetch_add(1, std::memory_order_relaxed) % size];
+        if (isAvailable(index))
+        {
+            DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+            return server_table_->getFd(index);
+        }
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table
+//-------------------------------------------------------------------
+void SchedRR::serverAdded(int)
+{
+    build();
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedRR::serverRemoved(int)
+{
+    build();
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes, which may make it saturated or available
+//-------------------------------------------------------------------
+void SchedRR::loadChanged(int index, int old_load)
+{
+    available_ += capacityChange(index, old_load);
+}
+
+//-------------------------------------------------------------------
+// All the servers of a new table are taken at once.
+//-------------------------------------------------------------------
+void SchedRR::loadTable()
+{
+    build();
+}
+
+//-------------------------------------------------------------------
+// Collect the servers in the table into the dense array, in order of
+// their indexes, and count the servers with capacity.
+//-------------------------------------------------------------------
+void SchedRR::build()
+{
+    int available = 0;
+
+    servers_.clear();
+    for (int i = 0; i < server_table_->size(); i++)
     {
-        offset = count % sched_map_.size();
-        it = sched_map_.begin();
-        std::advance(it, offset);
-        if (it == backup)
-            return -1;
-        count++;
+        if (!server_table_->inUse(i))
+            continue;
+
+        servers_.push_back(i);
+        if (isAvailable(i))
+            available++;
     }
 
-    DebugCode(std::cout << "selected server: " << it->first << std::endl;)
-    return it->first;
-}
\ No newline at end of file
+    available_ = available;
+    next_ = 0;
+}
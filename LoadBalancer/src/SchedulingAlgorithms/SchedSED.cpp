@@ -0,0 +1,21 @@
+/////////////////////////////////////////////////////////////////////
+//  SchedSED.cpp - implementation of Shortest Expected Delay algorithm
+//  ver 1.0
+//  Language:      standard C++
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/SchedAlgorithms.h"
+
+//-------------------------------------------------------------------
+// Servers are compared by (current load + 1) / (capacity), with
+// multiplication instead of division.
+//-------------------------------------------------------------------
+bool SchedSED::lessDelay(const RealServer& a, const RealServer& b)
+{
+    return static_cast<long long>(a.cur_load + 1) * b.max_load <
+           static_cast<long long>(b.cur_load + 1) * a.max_load;
+}
@@ -12,38 +12,174 @@
 
 
 //-------------------------------------------------------------------
-// Select servers one by one, according to their weights, which are
-// represented by max load - cur_load.
+// Constructor
+//-------------------------------------------------------------------
+SchedWRR::SchedWRR() : next_(0), available_(0), stale_(false)
+{
+    pthread_mutex_init(&mtx_, NULL);
+}
+
+//-------------------------------------------------------------------
+// Destructor
+//-------------------------------------------------------------------
+SchedWRR::~SchedWRR()
+{
+    pthread_mutex_destroy(&mtx_);
+}
+
+//-------------------------------------------------------------------
+// Select the next server of the round. If a server is not available,
+// its turn is given to the next server in the round. A round made
+// stale by added or removed servers is built again first.
 // return : >0  file descriptor of selected server's socket
 //          -1  no available server 
 //-------------------------------------------------------------------
 int SchedWRR::selectServer()
 {
-    SchedMap::iterator it = sched_map_.begin();
+    if (stale_.load(std::memory_order_acquire))
+        build();
+
+    std::shared_ptr<const std::vector<int> > round = std::atomic_load(&round_);
+    int size = round ? round->size() : 0;
+    if (size == 0 || available_.load(std::memory_order_relaxed) <= 0)
+        return -1;
+
+    for (int i = 0; i < size; i++)
+    {
+        int index = (*round)[next_.fetch_add(1, std::memory_order_relaxed) % size];
+        if (isAvailable(index))
+        {
+            DebugCode(std::cout << "selected server: " << server_table_->getFd(index) << std::endl;)
+            return server_table_->getFd(index);
+        }
+    }
+
+    return -1;
+}
+
+//-------------------------------------------------------------------
+// A server is added into the server table. The round is built at the
+// next selection, so that adding many servers builds it only once.
+//-------------------------------------------------------------------
+void SchedWRR::serverAdded(int)
+{
+    stale_ = true;
+}
+
+//-------------------------------------------------------------------
+// A server is removed from the server table
+//-------------------------------------------------------------------
+void SchedWRR::serverRemoved(int)
+{
+    stale_ = true;
+}
+
+//-------------------------------------------------------------------
+// Load of a server changes, which may make it saturated or available.
+// A stale round counts the available servers again when it is built.
+//-------------------------------------------------------------------
+void SchedWRR::loadChanged(int index, int old_load)
+{
+    if (!stale_.load(std::memory_order_relaxed))
+        available_ += capacityChange(index, old_load);
+}
+
+//-------------------------------------------------------------------
+// All the servers of a new table are taken at once.
+//-------------------------------------------------------------------
+void SchedWRR::loadTable()
+{
+    stale_ = true;
+    build();
+}
+
+//-------------------------------------------------------------------
+// Compute the order of one round. The weight of a server is its max
+// load. Weights are divided by their greatest common divisor, so that
+// a round is as short as possible. After one round, every current
+// weight is back to 0, so the rounds repeat.
+// Threads which find the round stale at the same time wait for the
+// first of them to build it.
+//-------------------------------------------------------------------
+void SchedWRR::build()
+{
+    pthread_mutex_lock(&mtx_);
+    if (!stale_.load(std::memory_order_relaxed))
+    {
+        pthread_mutex_unlock(&mtx_);
+        return;
+    }
+
+    std::vector<int> indexes;
+    std::vector<long> weights;
+    long divisor = 0;
+    int available = 0;
 
-    for (; it != sched_map_.end(); it++)
+    for (int i = 0; i < server_table_->size(); i++)
     {
-        // First select a server who has enough capacity to 
-        // handle a request. If there's not one available,
-        // the for loop will be terminated, and return -1.
-        if (it->second.cur_load >= it->second.max_load - RESERVED_CAPACITY)
+        if (!server_table_->inUse(i))
+            continue;
+
+        if (isAvailable(i))
+            available++;
+
+        long weight = server_table_->get(i).max_load;
+        if (weight <= 0)
             continue;
 
-        SchedMap::iterator it2 = it;
-        it2++;
+        indexes.push_back(i);
+        weights.push_back(weight);
 
-        // Traverse the left servers to find whether there is
-        // one server's weight larger than this one.
-        for (; it2 != sched_map_.end(); it2++)
+        // greatest common divisor by Euclid's algorithm
+        long a = divisor, b = weight;
+        while (b != 0)
         {
-            if (it2->second.max_load - it2->second.cur_load >
-                it->second.max_load - it->second.cur_load)
-                it = it2;
+            long r = a % b;
+            a = b;
+            b = r;
         }
+        divisor = a;
+    }
 
-        DebugCode(std::cout << "selected server: " << it->first << std::endl;)
-        return it->first;
+    long total = 0;
+    for (auto& w : weights)
+    {
+        w /= divisor;
+        total += w;
     }
 
-    return -1;
+    if (total > MAX_ROUND_SIZE)
+    {
+        long scaled_total = 0;
+        for (auto& w : weights)
+        {
+            w = std::max(1L, w * MAX_ROUND_SIZE / total);
+            scaled_total += w;
+        }
+        total = scaled_total;
+    }
+
+    std::shared_ptr<std::vector<int> > round = std::make_shared<std::vector<int> >();
+    round->reserve(total);
+
+    std::vector<long> current(weights.size(), 0);
+    for (long n = 0; n < total; n++)
+    {
+        size_t best = 0;
+        for (size_t k = 0; k < weights.size(); k++)
+        {
+            current[k] += weights[k];
+            if (current[k] > current[best])
+                best = k;
+        }
+
+        current[best] -= total;
+        round->push_back(indexes[best]);
+    }
+
+    std::atomic_store(&round_, std::shared_ptr<const std::vector<int> >(round));
+    available_ = available;
+    next_ = 0;
+    stale_.store(false, std::memory_order_release);
+    pthread_mutex_unlock(&mtx_);
 }
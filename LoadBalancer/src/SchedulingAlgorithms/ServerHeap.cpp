@@ -0,0 +1,158 @@
+/////////////////////////////////////////////////////////////////////
+//  ServerHeap.cpp - implementation of ServerHeap class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include "../../include/SchedulingAlgorithms/ServerHeap.h"
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+ServerHeap::ServerHeap(Less less)
+    : server_table_(nullptr), less_(less)
+{}
+
+//-------------------------------------------------------------------
+// Set the table the servers come from. The heap is cleared.
+//-------------------------------------------------------------------
+void ServerHeap::setServerTable(const ServerTable *server_table)
+{
+    server_table_ = server_table;
+    clear();
+}
+
+//-------------------------------------------------------------------
+// Take all the servers out
+//-------------------------------------------------------------------
+void ServerHeap::clear()
+{
+    heap_.clear();
+    position_.clear();
+}
+
+//-------------------------------------------------------------------
+// Put a server into the heap, or move it after its key has changed.
+// Only one of siftUp() and siftDown() can move it.
+//-------------------------------------------------------------------
+void ServerHeap::update(int index)
+{
+    if (index >= static_cast<int>(position_.size()))
+        position_.resize(index + 1, -1);
+
+    size_t pos;
+    if (position_[index] == -1)
+    {
+        pos = heap_.size();
+        heap_.push_back(index);
+        position_[index] = pos;
+    }
+    else
+        pos = position_[index];
+
+    siftUp(pos);
+    siftDown(position_[index]);
+}
+
+//-------------------------------------------------------------------
+// Take a server out of the heap. The last server fills its place and
+// is moved up or down from there.
+//-------------------------------------------------------------------
+void ServerHeap::erase(int index)
+{
+    if (!contains(index))
+        return;
+
+    size_t pos = position_[index];
+    int last = heap_.back();
+    heap_.pop_back();
+    position_[index] = -1;
+
+    if (pos < heap_.size())
+    {
+        place(pos, last);
+        siftUp(pos);
+        siftDown(position_[last]);
+    }
+}
+
+//-------------------------------------------------------------------
+// Whether a server is in the heap
+//-------------------------------------------------------------------
+bool ServerHeap::contains(int index) const
+{
+    return index >= 0 && index < static_cast<int>(position_.size()) &&
+           position_[index] != -1;
+}
+
+//-------------------------------------------------------------------
+// Compare two servers by the function given, then by index.
+//-------------------------------------------------------------------
+bool ServerHeap::before(int a, int b) const
+{
+    const RealServer& server_a = server_table_->get(a);
+    const RealServer& server_b = server_table_->get(b);
+
+    if (less_(server_a, server_b))
+        return true;
+    if (less_(server_b, server_a))
+        return false;
+    return a < b;
+}
+
+//-------------------------------------------------------------------
+// Move the server at pos up while it goes before its parent.
+//-------------------------------------------------------------------
+void ServerHeap::siftUp(size_t pos)
+{
+    int index = heap_[pos];
+
+    while (pos > 0)
+    {
+        size_t parent = (pos - 1) / 2;
+        if (!before(index, heap_[parent]))
+            break;
+
+        place(pos, heap_[parent]);
+        pos = parent;
+    }
+
+    place(pos, index);
+}
+
+//-------------------------------------------------------------------
+// Move the server at pos down while one of its children goes before
+// it.
+//-------------------------------------------------------------------
+void ServerHeap::siftDown(size_t pos)
+{
+    int index = heap_[pos];
+    size_t size = heap_.size();
+
+    while (2 * pos + 1 < size)
+    {
+        size_t child = 2 * pos + 1;
+        if (child + 1 < size && before(heap_[child + 1], heap_[child]))
+            child++;
+        if (!before(heap_[child], index))
+            break;
+
+        place(pos, heap_[child]);
+        pos = child;
+    }
+
+    place(pos, index);
+}
+
+//-------------------------------------------------------------------
+// Put a server at pos of the heap and record its position.
+//-------------------------------------------------------------------
+void ServerHeap::place(size_t pos, int index)
+{
+    heap_[pos] = index;
+    position_[index] = pos;
+}
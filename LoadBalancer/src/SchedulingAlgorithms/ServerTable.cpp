@@ -0,0 +1,209 @@
+/////////////////////////////////////////////////////////////////////
+//  ServerTable.cpp - implementation of ServerTable class
+//  ver 1.0
+//  Language:      standard C++ 11
+//  Platform:      Ubuntu 14.04, 32-bit
+//  Application:   2014 Summer Project
+//  Author:        Chunxu Tang, Syracuse University
+//                 chunxutang@gmail.com
+/////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include "../../include/SchedulingAlgorithms/ServerTable.h"
+
+const uint64_t ServerTable::LATENCY_DECAY_INTERVAL;
+
+//-------------------------------------------------------------------
+// Constructor
+//-------------------------------------------------------------------
+ServerTable::ServerTable()
+    : count_(0)
+{}
+
+//-------------------------------------------------------------------
+// Add a server. The array grows when index is beyond its end, or when
+// there is no free slot.
+//-------------------------------------------------------------------
+int ServerTable::add(int fd, const RealServer& server, int index)
+{
+    if (fd_index_.find(fd) != fd_index_.end())
+        return -1;
+
+    if (index < 0)
+    {
+        index = 0;
+        while (index < size() && slots_[index].in_use)
+            index++;
+    }
+
+    if (index >= size())
+    {
+        Slot free_slot = { -1, false, RealServer() };
+        slots_.resize(index + 1, free_slot);
+    }
+    else if (slots_[index].in_use)
+        return -1;
+
+    Slot& slot = slots_[index];
+    slot.fd = fd;
+    slot.in_use = true;
+    slot.server = server;
+    fd_index_[fd] = index;
+    count_++;
+
+    for (auto x : listeners_)
+        x->serverAdded(index);
+
+    return index;
+}
+
+//-------------------------------------------------------------------
+// Remove a server. Its slot is kept, so indexes of other servers do
+// not change.
+//-------------------------------------------------------------------
+void ServerTable::remove(int index)
+{
+    if (index < 0 || index >= size() || !slots_[index].in_use)
+        return;
+
+    Slot& slot = slots_[index];
+    fd_index_.erase(slot.fd);
+    slot.fd = -1;
+    slot.in_use = false;
+    count_--;
+
+    for (auto x : listeners_)
+        x->serverRemoved(index);
+}
+
+//-------------------------------------------------------------------
+// Find a server by fd
+//-------------------------------------------------------------------
+int ServerTable::find(int fd) const
+{
+    auto it = fd_index_.find(fd);
+    return (it == fd_index_.end()) ? -1 : it->second;
+}
+
+//-------------------------------------------------------------------
+// Set current load of a server. Nothing is told if it does not change.
+//-------------------------------------------------------------------
+void ServerTable::setLoad(int index, int cur_load)
+{
+    RealServer& server = slots_[index].server;
+    int old_load = server.cur_load;
+    if (old_load == cur_load)
+        return;
+
+    server.cur_load = cur_load;
+    for (auto x : listeners_)
+        x->loadChanged(index, old_load);
+}
+
+//-------------------------------------------------------------------
+// Increase current load of a server by 1
+//-------------------------------------------------------------------
+void ServerTable::increment(int index)
+{
+    setLoad(index, slots_[index].server.cur_load + 1);
+}
+
+//-------------------------------------------------------------------
+// Decrease current load of a server by 1
+//-------------------------------------------------------------------
+void ServerTable::decrement(int index)
+{
+    setLoad(index, slots_[index].server.cur_load - 1);
+}
+
+//-------------------------------------------------------------------
+// Change max load of a server
+//-------------------------------------------------------------------
+void ServerTable::setMaxLoad(int index, int max_load)
+{
+    slots_[index].server.max_load = max_load;
+}
+
+//-------------------------------------------------------------------
+// Peak EWMA: the average follows a slower response at once, so a
+// server in a pause stops getting requests quickly, and goes back
+// down with samples taken later, or by decayLatency() if it gets no
+// more requests.
+//-------------------------------------------------------------------
+void ServerTable::addLatency(int index, uint64_t rtt, uint64_t now)
+{
+    if (index < 0 || index >= size() || !slots_[index].in_use)
+        return;
+
+    const RealServer& server = slots_[index].server;
+    setLatency(index, peakEWMA(server.latency, server.latency_time, rtt, now), now);
+}
+
+//-------------------------------------------------------------------
+// Set the average response time of a server, e.g. copied from the
+// average shared by the workers.
+//-------------------------------------------------------------------
+void ServerTable::setLatency(int index, double latency, uint64_t latency_time)
+{
+    if (index < 0 || index >= size() || !slots_[index].in_use)
+        return;
+
+    RealServer& server = slots_[index].server;
+    server.latency = latency;
+    server.latency_time = (latency_time == 0) ? 1 : latency_time;
+
+    for (auto x : listeners_)
+        x->latencyChanged(index);
+}
+
+//-------------------------------------------------------------------
+// Compute a new peak EWMA with a sample
+//-------------------------------------------------------------------
+double ServerTable::peakEWMA(double latency, uint64_t latency_time,
+                             uint64_t rtt, uint64_t now)
+{
+    double sample = static_cast<double>(rtt);
+    if (latency_time == 0 || sample > latency)
+        return sample;
+
+    double elapsed = (now > latency_time) ? now - latency_time : 0;
+    double w = exp(-elapsed / LATENCY_DECAY);
+    return latency * w + sample * (1.0 - w);
+}
+
+//-------------------------------------------------------------------
+// Decay the averages, so that a server which has stopped getting
+// requests after a slow response is selected again some time later,
+// and its next samples bring its average to its real response time.
+// Listeners are told, so a heap ordered by latency is fixed.
+//-------------------------------------------------------------------
+void ServerTable::decayLatency(uint64_t now)
+{
+    for (int i = 0; i < size(); i++)
+    {
+        const RealServer& server = slots_[i].server;
+        if (!slots_[i].in_use || server.latency_time == 0 || 
+            server.latency_time >= now || server.latency <= 0.0)
+            continue;
+
+        setLatency(i, peakEWMA(server.latency, server.latency_time, 0, now), now);
+    }
+}
+
+//-------------------------------------------------------------------
+// Register a listener of changes
+//-------------------------------------------------------------------
+void ServerTable::addListener(Listener *listener)
+{
+    if (std::find(listeners_.begin(), listeners_.end(), listener) == listeners_.end())
+        listeners_.push_back(listener);
+}
+
+//-------------------------------------------------------------------
+// Unregister a listener
+//-------------------------------------------------------------------
+void ServerTable::removeListener(Listener *listener)
+{
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener),
+                     listeners_.end());
+}